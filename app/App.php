@@ -48,6 +48,17 @@ class App
         $this->tab->appendWithCallback($name, $control, $callback);
     }
     
+    /**
+     * 添加延迟创建的标签页，第一次选中时才创建 $class 实例并调用 $method 获取控件
+     */
+    public function addLazyTab(string $name, string $class, string $method = 'getControl')
+    {
+        $this->tab->appendLazy($name, function () use ($name, $class, $method) {
+            $this->tabs[$name] = new $class();
+            return $this->tabs[$name]->$method();
+        });
+    }
+    
     public function run()
     {
         // 主循环
@@ -0,0 +1,691 @@
+<?php
+
+namespace App;
+
+use FilesystemIterator;
+use Kingbes\Libui\SDK\LibuiProcess;
+use RecursiveDirectoryIterator;
+use RecursiveIteratorIterator;
+
+/**
+ * 基于内容哈希的增量打包
+ *
+ * 状态目录中的 manifest.json 记录了上一次打包的结果：
+ * - 复制目录：每个输出文件对应源文件的大小、修改时间和内容哈希。大小和修改时间都没变的文件直接跳过，
+ *   变化的文件重新计算哈希，内容确实变了才替换，并优先用硬链接（或 reflink）代替复制；
+ *   源目录中已删除的文件也会从输出目录删除
+ * - PHAR：每个条目源文件的大小、修改时间和哈希，只添加/删除变化的条目，没有变化时不重写
+ * - ZIP：每个条目源文件的大小、修改时间、哈希和在压缩包中的位置，未变化的条目直接复制上一次的压缩数据，
+ *   新条目由多个 PHP 命令行进程（scripts/compress-shard.php）并行压缩
+ *
+ * PHAR 和 ZIP 条目与复制目录一样，源文件大小和修改时间都没变时沿用清单中的哈希，不重新读取文件。
+ */
+class IncrementalBuilder
+{
+    public const LINK_HARDLINK = 'hardlink';
+    public const LINK_REFLINK = 'reflink';
+    public const LINK_COPY = 'copy';
+
+    private const MANIFEST_VERSION = 2;
+    private const HASH_ALGO = 'xxh128';
+    // 不使用 zip64 时的条目数和偏移量上限，超出时退回 ZipArchive
+    private const ZIP_MAX_ENTRIES = 65535;
+    private const ZIP_MAX_OFFSET = 0xFFFFFFFF;
+    private const ZIP_LOCAL_HEADER_SIZE = 30;
+
+    private string $stateDir;
+    private string $linkMode;
+    private int $workers;
+    private array $manifest;
+
+    private array $hashCache = [];      // "设备:inode:大小:修改时间" => 哈希，硬链接的文件只计算一次
+    private array $pendingCopies = [];  // reflink 模式下按目标目录分组的待复制文件
+    private array $stats = [];
+
+    /**
+     * @param string $stateDir 保存清单的目录（不能位于要打包的目录内）
+     * @param string $linkMode 未变化文件的放置方式：hardlink、reflink 或 copy
+     * @param int $workers 并行压缩的进程数
+     */
+    public function __construct(string $stateDir, string $linkMode = self::LINK_HARDLINK, int $workers = 4)
+    {
+        $this->stateDir = rtrim($stateDir, '/\\');
+        $this->linkMode = $linkMode;
+        $this->workers = max(1, $workers);
+        $this->manifest = $this->loadManifest();
+        $this->resetStats();
+    }
+
+    /**
+     * 丢弃上一次的打包记录，下一次按全新打包处理
+     */
+    public function reset(): void
+    {
+        $this->manifest = $this->emptyManifest();
+    }
+
+    public function save(): void
+    {
+        if (!is_dir($this->stateDir)) {
+            mkdir($this->stateDir, 0755, true);
+        }
+        $file = $this->stateDir . '/manifest.json';
+        file_put_contents($file . '.tmp', json_encode($this->manifest, JSON_UNESCAPED_SLASHES | JSON_UNESCAPED_UNICODE));
+        rename($file . '.tmp', $file);
+    }
+
+    /**
+     * 本次打包的统计：unchanged、linked、copied、removed、hashed、phar_added、phar_reused、
+     * phar_removed、zip_compressed、zip_reused
+     */
+    public function getStats(): array
+    {
+        return $this->stats;
+    }
+
+    public function resetStats(): void
+    {
+        $this->stats = array_fill_keys([
+            'unchanged', 'linked', 'copied', 'removed', 'hashed',
+            'phar_added', 'phar_reused', 'phar_removed', 'zip_compressed', 'zip_reused',
+        ], 0);
+    }
+
+    /**
+     * 列出目录下的所有文件
+     *
+     * @return array 相对路径（/ 分隔）=> 完整路径，按相对路径排序
+     */
+    public static function listFiles(string $dir): array
+    {
+        $dir = rtrim($dir, '/\\');
+        $files = [];
+        $iterator = new RecursiveIteratorIterator(new RecursiveDirectoryIterator($dir, FilesystemIterator::SKIP_DOTS));
+        foreach ($iterator as $path => $info) {
+            if ($info->isFile()) {
+                $files[str_replace('\\', '/', substr($path, strlen($dir) + 1))] = $path;
+            }
+        }
+        ksort($files, SORT_STRING);
+        return $files;
+    }
+
+    /**
+     * 同步单个文件
+     *
+     * @param string $key 清单中的键（相对于打包目录的路径）
+     */
+    public function syncFile(string $src, string $dst, string $key): void
+    {
+        $this->syncEntry($src, $dst, $key);
+        $this->flushCopies();
+    }
+
+    /**
+     * 同步目录，代替删除后整体复制
+     *
+     * @param string $keyPrefix 该目录在清单中的键前缀（相对于打包目录的路径）
+     */
+    public function syncDirectory(string $src, string $dst, string $keyPrefix): void
+    {
+        $src = rtrim($src, '/\\');
+        $dst = rtrim($dst, '/\\');
+        if (!is_dir($dst)) {
+            mkdir($dst, 0755, true);
+        }
+
+        $seen = [];
+        $iterator = new RecursiveIteratorIterator(
+            new RecursiveDirectoryIterator($src, FilesystemIterator::SKIP_DOTS),
+            RecursiveIteratorIterator::SELF_FIRST
+        );
+        foreach ($iterator as $path => $info) {
+            $relative = str_replace('\\', '/', substr($path, strlen($src) + 1));
+            $target = $dst . '/' . $relative;
+            if ($info->isDir() && !$info->isLink()) {
+                if (!is_dir($target)) {
+                    mkdir($target, 0755, true);
+                }
+                continue;
+            }
+            $key = $keyPrefix . '/' . $relative;
+            $seen[$key] = true;
+            $this->syncEntry($path, $target, $key);
+        }
+        $this->flushCopies();
+
+        // 删除源目录中已不存在的文件
+        $prefix = $keyPrefix . '/';
+        foreach (array_keys($this->manifest['files']) as $key) {
+            if (str_starts_with($key, $prefix) && !isset($seen[$key])) {
+                @unlink($dst . '/' . substr($key, strlen($prefix)));
+                unset($this->manifest['files'][$key]);
+                $this->stats['removed']++;
+            }
+        }
+    }
+
+    /**
+     * 从清单中移除某个目录下的所有文件（该目录不再参与打包时调用）
+     */
+    public function forget(string $keyPrefix): void
+    {
+        $prefix = $keyPrefix . '/';
+        foreach (array_keys($this->manifest['files']) as $key) {
+            if (str_starts_with($key, $prefix)) {
+                unset($this->manifest['files'][$key]);
+            }
+        }
+    }
+
+    /**
+     * 增量创建 PHAR
+     *
+     * @param array $entries 条目名 => 源文件路径
+     */
+    public function buildPhar(string $pharFile, array $entries, string $stub): void
+    {
+        $state = $this->manifest['phar'];
+        $files = [];
+        foreach ($entries as $entry => $path) {
+            $files[$entry] = $this->fileState($path, $state['entries'][$entry] ?? null);
+        }
+        $hashes = array_map(fn($file) => $file['hash'], $files);
+        $stubHash = hash(self::HASH_ALGO, $stub);
+
+        clearstatcache(true, $pharFile);
+        $incremental = $state !== null
+            && $state['path'] === $pharFile
+            && $state['stub'] === $stubHash
+            && is_file($pharFile)
+            && filesize($pharFile) === $state['size']
+            && filemtime($pharFile) === $state['mtime'];
+
+        if ($incremental) {
+            $previous = array_map(fn($file) => $file['hash'], $state['entries']);
+            $added = array_keys(array_diff_assoc($hashes, $previous));
+            $removed = array_keys(array_diff_key($previous, $hashes));
+            $this->stats['phar_reused'] += count($hashes) - count($added);
+            if (empty($added) && empty($removed)) {
+                // 只有修改时间变化的条目也要记下新的修改时间，下次不用重新计算哈希
+                $this->manifest['phar']['entries'] = $files;
+                return;
+            }
+        } else {
+            if (is_file($pharFile)) {
+                try {
+                    \Phar::unlinkArchive($pharFile);
+                } catch (\PharException $e) {
+                    // 不是有效的 PHAR，直接删除
+                    unlink($pharFile);
+                }
+            }
+            $added = array_keys($hashes);
+            $removed = [];
+        }
+
+        $phar = new \Phar($pharFile);
+        $phar->startBuffering();
+        foreach ($added as $entry) {
+            $phar->addFile($entries[$entry], $entry);
+        }
+        foreach ($removed as $entry) {
+            $phar->delete($entry);
+        }
+        if (!$incremental) {
+            $phar->setStub($stub);
+        }
+        $phar->stopBuffering();
+        unset($phar);
+
+        clearstatcache(true, $pharFile);
+        $this->stats['phar_added'] += count($added);
+        $this->stats['phar_removed'] += count($removed);
+        $this->manifest['phar'] = [
+            'path' => $pharFile,
+            'stub' => $stubHash,
+            'size' => filesize($pharFile),
+            'mtime' => filemtime($pharFile),
+            'entries' => $files,
+        ];
+    }
+
+    /**
+     * 增量创建 ZIP，打包 baseDir 下除压缩包本身以外的所有文件和目录
+     */
+    public function buildZip(string $zipFile, string $baseDir): void
+    {
+        $baseDir = rtrim($baseDir, '/\\');
+        $zipReal = realpath($zipFile);
+
+        // 目录条目以 / 结尾，和文件一起按名称排序
+        $items = [];
+        $iterator = new RecursiveIteratorIterator(
+            new RecursiveDirectoryIterator($baseDir, FilesystemIterator::SKIP_DOTS),
+            RecursiveIteratorIterator::SELF_FIRST
+        );
+        foreach ($iterator as $path => $info) {
+            if ($zipReal !== false && $info->getRealPath() === $zipReal) {
+                continue;
+            }
+            if ($path === $zipFile . '.tmp') {
+                continue;
+            }
+            $name = str_replace('\\', '/', substr($path, strlen($baseDir) + 1));
+            $items[$info->isDir() ? $name . '/' : $name] = $path;
+        }
+        ksort($items, SORT_STRING);
+
+        if (count($items) > self::ZIP_MAX_ENTRIES) {
+            $this->buildZipWithZipArchive($zipFile, $items);
+            return;
+        }
+
+        $state = $this->manifest['zip'];
+        clearstatcache(true, $zipFile);
+        $reusable = $state !== null
+            && $state['path'] === $zipFile
+            && is_file($zipFile)
+            && filesize($zipFile) === $state['size']
+            && filemtime($zipFile) === $state['mtime'];
+
+        $files = [];
+        $compress = [];
+        foreach ($items as $name => $path) {
+            if (str_ends_with($name, '/')) {
+                continue;
+            }
+            $previous = $state['entries'][$name] ?? null;
+            $files[$name] = $this->fileState($path, $previous);
+            if (!$reusable || $previous === null || $previous['hash'] !== $files[$name]['hash']) {
+                $compress[$name] = $path;
+            }
+        }
+
+        // 条目列表和内容都没变时不重写压缩包
+        $itemsHash = hash(self::HASH_ALGO, implode("\n", array_keys($items)));
+        if ($reusable && empty($compress) && ($state['items'] ?? null) === $itemsHash) {
+            foreach ($files as $name => $file) {
+                $this->manifest['zip']['entries'][$name]['mtime'] = $file['mtime'];
+            }
+            $this->stats['zip_reused'] += count($files);
+            return;
+        }
+
+        $tmpDir = $this->stateDir . '/zip-' . getmypid();
+        $tmpFile = $zipFile . '.tmp';
+        $out = null;
+        $old = null;
+        $blobHandles = [];
+        $central = '';
+        $entries = [];
+        $offset = 0;
+        $overflow = false;
+
+        // 出错时也要删除压缩分片和未完成的临时压缩包
+        try {
+            $blobs = $this->compressEntries($compress, $tmpDir);
+            $out = fopen($tmpFile, 'wb');
+            if ($out === false) {
+                throw new \RuntimeException("无法创建临时文件: $tmpFile");
+            }
+            $old = $reusable ? fopen($zipFile, 'rb') : null;
+            if ($old === false) {
+                throw new \RuntimeException("无法读取压缩包: $zipFile");
+            }
+
+            foreach ($items as $name => $path) {
+                if (str_ends_with($name, '/')) {
+                    [$time, $date] = self::dosTime(filemtime($path));
+                    $entry = ['method' => 0, 'time' => $time, 'date' => $date, 'crc' => 0, 'csize' => 0, 'size' => 0];
+                    fwrite($out, $this->localHeader($name, $entry));
+                } elseif (isset($blobs[$name])) {
+                    $blob = $blobs[$name];
+                    [$time, $date] = self::dosTime(filemtime($path));
+                    $entry = [
+                        'method' => $blob['method'], 'time' => $time, 'date' => $date,
+                        'crc' => $blob['crc'], 'csize' => $blob['length'], 'size' => $blob['size'],
+                    ];
+                    fwrite($out, $this->localHeader($name, $entry));
+                    if (!isset($blobHandles[$blob['file']])) {
+                        $handle = fopen($blob['file'], 'rb');
+                        if ($handle === false) {
+                            throw new \RuntimeException("无法读取压缩数据: {$blob['file']}");
+                        }
+                        $blobHandles[$blob['file']] = $handle;
+                    }
+                    fseek($blobHandles[$blob['file']], $blob['offset']);
+                    stream_copy_to_stream($blobHandles[$blob['file']], $out, $blob['length']);
+                    $this->stats['zip_compressed']++;
+                } else {
+                    // 直接复制上一次压缩包中的本地文件头和压缩数据
+                    $entry = $state['entries'][$name];
+                    fseek($old, $entry['offset']);
+                    stream_copy_to_stream($old, $out, self::ZIP_LOCAL_HEADER_SIZE + strlen($name) + $entry['csize']);
+                    $this->stats['zip_reused']++;
+                }
+
+                $isDir = str_ends_with($name, '/');
+                $central .= $this->centralHeader($name, $entry, $offset, $isDir);
+                if (!$isDir) {
+                    $entries[$name] = ['hash' => $files[$name]['hash'], 'mtime' => $files[$name]['mtime'], 'offset' => $offset] + $entry;
+                }
+                $offset += self::ZIP_LOCAL_HEADER_SIZE + strlen($name) + $entry['csize'];
+                if ($offset > self::ZIP_MAX_OFFSET) {
+                    $overflow = true;
+                    break;
+                }
+            }
+        } catch (\Throwable $e) {
+            if (is_resource($out)) {
+                fclose($out);
+            }
+            @unlink($tmpFile);
+            throw $e;
+        } finally {
+            foreach ($blobHandles as $handle) {
+                fclose($handle);
+            }
+            if (is_resource($old)) {
+                fclose($old);
+            }
+            $this->removeDirectory($tmpDir);
+        }
+
+        if ($overflow || $offset + strlen($central) > self::ZIP_MAX_OFFSET) {
+            fclose($out);
+            unlink($tmpFile);
+            $this->buildZipWithZipArchive($zipFile, $items);
+            return;
+        }
+
+        fwrite($out, $central);
+        fwrite($out, pack('VvvvvVVv', 0x06054b50, 0, 0, count($items), count($items), strlen($central), $offset, 0));
+        fclose($out);
+        rename($tmpFile, $zipFile);
+
+        clearstatcache(true, $zipFile);
+        $this->manifest['zip'] = [
+            'path' => $zipFile,
+            'size' => filesize($zipFile),
+            'mtime' => filemtime($zipFile),
+            'items' => $itemsHash,
+            'entries' => $entries,
+        ];
+    }
+
+    /**
+     * 文件内容哈希，同一 inode 且大小和修改时间不变时只计算一次
+     */
+    public function hashFile(string $path): string
+    {
+        $stat = stat($path);
+        $key = $stat['dev'] . ':' . $stat['ino'] . ':' . $stat['size'] . ':' . $stat['mtime'];
+        if (!isset($this->hashCache[$key])) {
+            $this->hashCache[$key] = hash_file(self::HASH_ALGO, $path);
+            $this->stats['hashed']++;
+        }
+        return $this->hashCache[$key];
+    }
+
+    /**
+     * 源文件的大小、修改时间和哈希；大小和修改时间与上一次记录相同时沿用记录的哈希
+     */
+    private function fileState(string $path, ?array $previous): array
+    {
+        $stat = stat($path);
+        if ($previous !== null
+            && ($previous['size'] ?? null) === $stat['size']
+            && ($previous['mtime'] ?? null) === $stat['mtime']) {
+            return ['size' => $stat['size'], 'mtime' => $stat['mtime'], 'hash' => $previous['hash']];
+        }
+        return ['size' => $stat['size'], 'mtime' => $stat['mtime'], 'hash' => $this->hashFile($path)];
+    }
+
+    private function syncEntry(string $src, string $dst, string $key): void
+    {
+        $stat = stat($src);
+        $previous = $this->manifest['files'][$key] ?? null;
+
+        if ($previous !== null
+            && $previous['size'] === $stat['size']
+            && $previous['mtime'] === $stat['mtime']
+            && is_file($dst)) {
+            $this->stats['unchanged']++;
+            return;
+        }
+
+        $hash = $this->hashFile($src);
+        if ($previous !== null && $previous['hash'] === $hash && is_file($dst) && filesize($dst) === $stat['size']) {
+            // 只是修改时间变了
+            $this->stats['unchanged']++;
+        } else {
+            $this->place($src, $dst);
+        }
+        $this->manifest['files'][$key] = ['size' => $stat['size'], 'mtime' => $stat['mtime'], 'hash' => $hash];
+    }
+
+    /**
+     * 把源文件放到目标位置：优先硬链接，其次 reflink，最后复制
+     *
+     * 硬链接与源文件共享内容，就地修改源文件会同时改变输出；需要隔离时使用 reflink 或 copy 模式。
+     */
+    private function place(string $src, string $dst): void
+    {
+        if (file_exists($dst) || is_link($dst)) {
+            unlink($dst);
+        }
+        if ($this->linkMode === self::LINK_HARDLINK && @link($src, $dst)) {
+            $this->stats['linked']++;
+            return;
+        }
+        if ($this->linkMode === self::LINK_REFLINK && PHP_OS_FAMILY === 'Linux' && basename($src) === basename($dst)) {
+            // 同一目录的文件攒到一起，用一次 cp 完成
+            $this->pendingCopies[dirname($dst)][] = $src;
+            return;
+        }
+        $this->copyFile($src, $dst);
+    }
+
+    private function flushCopies(): void
+    {
+        foreach ($this->pendingCopies as $dir => $sources) {
+            foreach (array_chunk($sources, 256) as $chunk) {
+                $command = 'cp --reflink=auto -p -- ' . implode(' ', array_map('escapeshellarg', $chunk))
+                    . ' ' . escapeshellarg($dir . '/') . ' 2>/dev/null';
+                exec($command, $output, $code);
+                if ($code === 0) {
+                    $this->stats['copied'] += count($chunk);
+                    continue;
+                }
+                foreach ($chunk as $src) {
+                    $this->copyFile($src, $dir . '/' . basename($src));
+                }
+            }
+        }
+        $this->pendingCopies = [];
+    }
+
+    private function copyFile(string $src, string $dst): void
+    {
+        copy($src, $dst);
+        // 保留修改时间，ZIP 条目时间与源文件一致
+        touch($dst, filemtime($src));
+        $this->stats['copied']++;
+    }
+
+    /**
+     * 压缩新条目，按文件大小分给多个 PHP 命令行进程
+     *
+     * 不在当前进程中 fork：打包在界面进程中执行，fork 出的副本会带着 GTK 等库的状态。
+     *
+     * @return array 条目名 => ['file', 'offset', 'length', 'method', 'crc', 'size']
+     */
+    private function compressEntries(array $files, string $tmpDir): array
+    {
+        if (empty($files)) {
+            return [];
+        }
+        if (!is_dir($tmpDir)) {
+            mkdir($tmpDir, 0755, true);
+        }
+
+        $helper = dirname(__DIR__) . '/scripts/compress-shard.php';
+        $workers = PHP_BINARY !== '' && is_file($helper) ? min($this->workers, count($files)) : 1;
+        if ($workers <= 1) {
+            return self::compressShard($files, $tmpDir . '/0');
+        }
+
+        // 从大到小轮流分配，使各进程的压缩量接近
+        $sizes = array_map('filesize', $files);
+        arsort($sizes);
+        $shards = array_fill(0, $workers, []);
+        $i = 0;
+        foreach (array_keys($sizes) as $name) {
+            $shards[$i++ % $workers][$name] = $files[$name];
+        }
+
+        $processes = [];
+        $errors = [];
+        foreach ($shards as $index => $shard) {
+            $base = $tmpDir . '/' . $index;
+            file_put_contents($base . '.list', serialize($shard));
+            $processes[$index] = (new LibuiProcess([PHP_BINARY, $helper, $base]))
+                ->onLine(function (string $line, string $stream) use (&$errors) {
+                    if ($stream === LibuiProcess::STDERR && $line !== '') {
+                        $errors[] = $line;
+                    }
+                })
+                ->start();
+        }
+
+        // 等待所有进程结束后再检查结果，失败时不留下仍在运行的进程
+        $blobs = [];
+        $failed = false;
+        foreach ($processes as $index => $process) {
+            $exitCode = $process->wait();
+            $shardIndex = @file_get_contents($tmpDir . '/' . $index . '.idx');
+            if ($exitCode !== 0 || $shardIndex === false) {
+                $failed = true;
+                continue;
+            }
+            $blobs += unserialize($shardIndex);
+        }
+        if ($failed) {
+            throw new \RuntimeException("压缩进程异常退出" . (empty($errors) ? "" : ": " . implode("\n", $errors)));
+        }
+        return $blobs;
+    }
+
+    /**
+     * 把一组文件压缩到 $base.bin，索引写入 $base.idx（scripts/compress-shard.php 也调用此方法）
+     */
+    public static function compressShard(array $files, string $base): array
+    {
+        $handle = fopen($base . '.bin', 'wb');
+        if ($handle === false) {
+            throw new \RuntimeException("无法创建文件: $base.bin");
+        }
+        $offset = 0;
+        $index = [];
+        foreach ($files as $name => $path) {
+            $data = (string)file_get_contents($path);
+            $compressed = gzdeflate($data, 6);
+            // 压缩后没有变小的文件直接存储
+            $method = 8;
+            if ($compressed === false || strlen($compressed) >= strlen($data)) {
+                $compressed = $data;
+                $method = 0;
+            }
+            fwrite($handle, $compressed);
+            $index[$name] = [
+                'file' => $base . '.bin',
+                'offset' => $offset,
+                'length' => strlen($compressed),
+                'method' => $method,
+                'crc' => crc32($data),
+                'size' => strlen($data),
+            ];
+            $offset += strlen($compressed);
+        }
+        fclose($handle);
+        // 索引最后写入，存在即表示该分片已完成
+        file_put_contents($base . '.idx.tmp', serialize($index));
+        rename($base . '.idx.tmp', $base . '.idx');
+        return $index;
+    }
+
+    /**
+     * 条目数或大小超出普通 ZIP 格式时，用 ZipArchive 全量打包
+     */
+    private function buildZipWithZipArchive(string $zipFile, array $items): void
+    {
+        $zip = new \ZipArchive();
+        if ($zip->open($zipFile, \ZipArchive::CREATE | \ZipArchive::OVERWRITE) !== true) {
+            throw new \RuntimeException("无法创建压缩包: $zipFile");
+        }
+        foreach ($items as $name => $path) {
+            if (str_ends_with($name, '/')) {
+                $zip->addEmptyDir(rtrim($name, '/'));
+            } else {
+                $zip->addFile($path, $name);
+                $this->stats['zip_compressed']++;
+            }
+        }
+        $zip->close();
+        $this->manifest['zip'] = null;
+    }
+
+    private function localHeader(string $name, array $entry): string
+    {
+        // 0x0800: 文件名使用 UTF-8
+        return pack('VvvvvvVVVvv', 0x04034b50, 20, 0x0800, $entry['method'], $entry['time'], $entry['date'],
+            $entry['crc'], $entry['csize'], $entry['size'], strlen($name), 0) . $name;
+    }
+
+    private function centralHeader(string $name, array $entry, int $offset, bool $isDir): string
+    {
+        // 外部属性：高 16 位为 Unix 权限，0x10 为 DOS 目录标志
+        $attributes = $isDir ? (0040755 << 16) | 0x10 : (0100644 << 16);
+        return pack('VvvvvvvVVVvvvvvVV', 0x02014b50, 0x031E, 20, 0x0800, $entry['method'], $entry['time'], $entry['date'],
+            $entry['crc'], $entry['csize'], $entry['size'], strlen($name), 0, 0, 0, 0, $attributes, $offset) . $name;
+    }
+
+    /**
+     * Unix 时间戳转 DOS 时间和日期
+     */
+    private static function dosTime(int $timestamp): array
+    {
+        $t = getdate(max($timestamp, mktime(0, 0, 0, 1, 1, 1980)));
+        return [
+            ($t['hours'] << 11) | ($t['minutes'] << 5) | ($t['seconds'] >> 1),
+            (($t['year'] - 1980) << 9) | ($t['mon'] << 5) | $t['mday'],
+        ];
+    }
+
+    private function loadManifest(): array
+    {
+        $file = $this->stateDir . '/manifest.json';
+        $manifest = is_file($file) ? json_decode((string)file_get_contents($file), true) : null;
+        if (!is_array($manifest) || ($manifest['version'] ?? null) !== self::MANIFEST_VERSION) {
+            return $this->emptyManifest();
+        }
+        return $manifest;
+    }
+
+    private function emptyManifest(): array
+    {
+        return ['version' => self::MANIFEST_VERSION, 'files' => [], 'phar' => null, 'zip' => null];
+    }
+
+    private function removeDirectory(string $dir): void
+    {
+        if (!is_dir($dir)) {
+            return;
+        }
+        foreach (array_diff(scandir($dir), ['.', '..']) as $file) {
+            unlink($dir . '/' . $file);
+        }
+        rmdir($dir);
+    }
+}
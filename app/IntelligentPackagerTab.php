@@ -16,6 +16,7 @@ use Kingbes\Libui\App as LibuiApp;
 use Kingbes\Libui\Window;
 use Kingbes\Libui\Combobox;
 use Kingbes\Libui\Spinbox;
+use Kingbes\Libui\SDK\LibuiProcess;
 
 class IntelligentPackagerTab
 {
@@ -26,6 +27,8 @@ class IntelligentPackagerTab
     private $appVersionEntry;
     private $includeVendorCheckbox;
     private $includePharCheckbox;
+    private $incrementalCheckbox;
+    private $builder;
     private $outputArea;
     private $progressBar;
     private $packageButton;
@@ -40,6 +43,7 @@ class IntelligentPackagerTab
     private $prevButton;
     private $nextButton;
     private $tempOutput = ''; // 临时存储输出内容，直到$outputArea初始化完成
+    private $analysisProcess = null; // 正在运行的参数分析命令
     
     // 新增：步骤控制相关属性
     private $stepContainer;
@@ -300,6 +304,11 @@ class IntelligentPackagerTab
         Checkbox::setChecked($this->includePharCheckbox, true);
         Box::append($inputBox, $this->includePharCheckbox, false);
 
+        // 增量打包复选框
+        $this->incrementalCheckbox = Checkbox::create("增量打包（复用未变化的文件）");
+        Checkbox::setChecked($this->incrementalCheckbox, true);
+        Box::append($inputBox, $this->incrementalCheckbox, false);
+
         // 按钮容器
         $buttonBox = Box::newHorizontalBox();
         Box::setPadded($buttonBox, true);
@@ -466,15 +475,37 @@ class IntelligentPackagerTab
                 return;
             }
 
+            // 上一次分析还在运行时忽略重复点击
+            if ($this->analysisProcess !== null && $this->analysisProcess->isRunning()) {
+                $this->appendOutput("参数分析正在进行中，请稍候\n");
+                return;
+            }
+
             // 保存CLI文件路径
             $this->cliFile = $sourceFile;
 
             // 清空之前的参数
             $this->cliParameters = [];
 
-            // 通过运行CLI程序获取帮助信息来分析参数
-            $this->parseCliParametersByExecution();
+            // 通过运行CLI程序获取帮助信息来分析参数，命令异步执行，完成后继续
+            $this->parseCliParametersByExecution(function () {
+                $this->finishCliAnalysis();
+            });
+        } catch (\Exception $e) {
+            $this->appendOutput("analyzeCliParameters 方法中发生异常: " . $e->getMessage() . "\n");
+            $this->appendOutput("异常跟踪: " . $e->getTraceAsString() . "\n");
+        } catch (\Error $e) {
+            $this->appendOutput("analyzeCliParameters 方法中发生错误: " . $e->getMessage() . "\n");
+            $this->appendOutput("错误跟踪: " . $e->getTraceAsString() . "\n");
+        }
+    }
 
+    /**
+     * 帮助信息解析完成后更新界面
+     */
+    private function finishCliAnalysis()
+    {
+        try {
             // 标记分析已完成
             $this->analysisCompleted = true;
 
@@ -510,7 +541,12 @@ class IntelligentPackagerTab
         }
     }
 
-    private function parseCliParametersByExecution()
+    /**
+     * 依次尝试各种帮助参数运行CLI程序，每条命令最多等待10秒
+     *
+     * @param callable $onDone 解析完成后回调
+     */
+    private function parseCliParametersByExecution(callable $onDone)
     {
         try {
             $this->appendOutput("进入 parseCliParametersByExecution 方法\n");
@@ -536,167 +572,96 @@ class IntelligentPackagerTab
 
             // 尝试不同的帮助命令
             $helpCommands = [' --help', ' -h', ' /?', ' --usage', ' -help', ' help'];
-            $helpOutput = '';
-
-            foreach ($helpCommands as $helpCmd) {
-                $fullCommand = $command . $helpCmd . ' 2>&1';
-                $this->appendOutput("执行命令: $fullCommand\n");
-                $output = [];
-                $returnCode = 0;
-
-                // 使用exec而不是system来捕获输出，添加超时机制
-                $descriptorspec = array(
-                   0 => array("pipe", "r"),
-                   1 => array("pipe", "w"),
-                   2 => array("pipe", "w")
-                );
-
-                $process = proc_open($fullCommand, $descriptorspec, $pipes);
-
-                if (is_resource($process)) {
-                    // 设置非阻塞模式
-                    stream_set_blocking($pipes[1], false);
-                    stream_set_blocking($pipes[2], false);
-
-                    $output = '';
-                    $errors = '';
-                    $startTime = time();
-
-                    // 等待最多10秒
-                    while (time() - $startTime < 10) {
-                        $status = proc_get_status($process);
-                        if (!$status['running']) {
-                            break;
-                        }
-
-                        // 读取输出
-                        $output .= fread($pipes[1], 8192);
-                        $errors .= fread($pipes[2], 8192);
-
-                        // 短暂休眠
-                        usleep(100000); // 100ms
-                    }
-
-                    // 关闭管道
-                    fclose($pipes[1]);
-                    fclose($pipes[2]);
-
-                    // 获取返回码
-                    $status = proc_get_status($process);
-                    $returnCode = $status['exitcode'];
-                    proc_close($process);
-
-                    // 分割输出为行数组
-                    $outputLines = explode("\n", trim($output));
-                    if (!empty($errors)) {
-                        $outputLines = array_merge($outputLines, explode("\n", trim($errors)));
-                    }
-
-                    // 收集输出
-                    $helpOutput .= implode("\n", $outputLines);
-                    $this->appendOutput("命令返回码: $returnCode, 输出行数: " . count($outputLines) . "\n");
-
-                    // 如果命令成功执行或返回常见的帮助信息退出码
-                    if ($returnCode <= 1 && !empty($outputLines)) {
-                        break;
-                    }
-                } else {
-                    $this->appendOutput("无法启动进程\n");
-                }
-            }
+            $this->probeHelpCommand($command, $helpCommands, '', $onDone);
+        } catch (\Exception $e) {
+            $this->appendOutput("parseCliParametersByExecution 方法中发生异常: " . $e->getMessage() . "\n");
+            $this->appendOutput("异常跟踪: " . $e->getTraceAsString() . "\n");
+        } catch (\Error $e) {
+            $this->appendOutput("parseCliParametersByExecution 方法中发生错误: " . $e->getMessage() . "\n");
+            $this->appendOutput("错误跟踪: " . $e->getTraceAsString() . "\n");
+        }
+    }
 
+    /**
+     * 执行下一条帮助命令，拿到帮助信息或全部尝试完后结束
+     */
+    private function probeHelpCommand($command, array $helpCommands, $helpOutput, callable $onDone)
+    {
+        if (empty($helpCommands)) {
             // 如果没有获取到帮助信息，尝试直接运行命令看是否有帮助信息输出
             if (empty($helpOutput)) {
-                $fullCommand = $command . ' 2>&1';
-                $this->appendOutput("执行命令: $fullCommand\n");
-                $output = [];
-                $returnCode = 0;
-
-                // 使用proc_open而不是exec来捕获输出，添加超时机制
-                $descriptorspec = array(
-                   0 => array("pipe", "r"),
-                   1 => array("pipe", "w"),
-                   2 => array("pipe", "w")
-                );
-
-                $process = proc_open($fullCommand, $descriptorspec, $pipes);
-
-                if (is_resource($process)) {
-                    // 设置非阻塞模式
-                    stream_set_blocking($pipes[1], false);
-                    stream_set_blocking($pipes[2], false);
-
-                    $outputStr = '';
-                    $errors = '';
-                    $startTime = time();
-
-                    // 等待最多10秒
-                    while (time() - $startTime < 10) {
-                        $status = proc_get_status($process);
-                        if (!$status['running']) {
-                            break;
-                        }
-
-                        // 读取输出
-                        $outputStr .= fread($pipes[1], 8192);
-                        $errors .= fread($pipes[2], 8192);
-
-                        // 短暂休眠
-                        usleep(100000); // 100ms
-                    }
-
-                    // 关闭管道
-                    fclose($pipes[1]);
-                    fclose($pipes[2]);
-
-                    // 获取返回码
-                    $status = proc_get_status($process);
-                    $returnCode = $status['exitcode'];
-                    proc_close($process);
-
-                    // 分割输出为行数组
-                    $outputLines = explode("\n", trim($outputStr));
-                    if (!empty($errors)) {
-                        $outputLines = array_merge($outputLines, explode("\n", trim($errors)));
-                    }
-
-                    $this->appendOutput("命令返回码: $returnCode, 输出行数: " . count($outputLines) . "\n");
-
+                $this->runHelpCommand($command . ' 2>&1', function ($outputLines) use ($onDone) {
                     // 如果程序输出了信息并且很快退出，可能是帮助信息
-                    if (!empty($outputLines)) {
-                        $helpOutput = implode("\n", $outputLines);
-                    }
-                } else {
-                    $this->appendOutput("无法启动进程\n");
-                }
+                    $this->finishHelpParsing(implode("\n", $outputLines), $onDone);
+                });
+            } else {
+                $this->finishHelpParsing($helpOutput, $onDone);
             }
+            return;
+        }
 
-            // 解析帮助信息中的参数
-            $this->parseHelpOutput($helpOutput);
+        $helpCmd = array_shift($helpCommands);
+        $this->runHelpCommand($command . $helpCmd . ' 2>&1', function ($outputLines, $returnCode) use ($command, $helpCommands, $helpOutput, $onDone) {
+            // 收集输出
+            $helpOutput .= implode("\n", $outputLines);
 
-            // 如果仍然没有参数，添加一个默认参数用于测试
-            if (empty($this->cliParameters)) {
-                $this->appendOutput("未检测到参数，添加默认参数用于测试\n");
-                $this->cliParameters['test'] = [
-                    'name' => 'test',
-                    'short' => null,
-                    'description' => '测试参数',
-                    'required' => false,
-                    'type' => 'string',
-                    'default' => ''
-                ];
+            // 如果命令成功执行或返回常见的帮助信息退出码
+            if ($returnCode <= 1 && !empty($outputLines)) {
+                $this->finishHelpParsing($helpOutput, $onDone);
+            } else {
+                $this->probeHelpCommand($command, $helpCommands, $helpOutput, $onDone);
             }
+        });
+    }
 
-            $this->appendOutput("退出 parseCliParametersByExecution 方法\n");
-        } catch (\Exception $e) {
-            $this->appendOutput("parseCliParametersByExecution 方法中发生异常: " . $e->getMessage() . "\n");
-            $this->appendOutput("异常跟踪: " . $e->getTraceAsString() . "\n");
-        } catch (\Error $e) {
-            $this->appendOutput("parseCliParametersByExecution 方法中发生错误: " . $e->getMessage() . "\n");
-            $this->appendOutput("错误跟踪: " . $e->getTraceAsString() . "\n");
+    /**
+     * 异步执行一条命令，最多等待10秒
+     *
+     * @param callable $callback function(array $outputLines, int $returnCode)
+     */
+    private function runHelpCommand($fullCommand, callable $callback)
+    {
+        $this->appendOutput("执行命令: $fullCommand\n");
+        try {
+            $this->analysisProcess = LibuiProcess::run($fullCommand, function (array $output, int $returnCode, array $errors) use ($callback) {
+                // 去掉首尾空行
+                $outputLines = explode("\n", trim(implode("\n", array_merge($output, $errors))));
+                if ($outputLines === ['']) {
+                    $outputLines = [];
+                }
+                $this->appendOutput("命令返回码: $returnCode, 输出行数: " . count($outputLines) . "\n");
+                $callback($outputLines, $returnCode);
+            }, 10);
+        } catch (\RuntimeException $e) {
+            $this->appendOutput("无法启动进程\n");
+            $callback([], -1);
         }
     }
 
+    private function finishHelpParsing($helpOutput, callable $onDone)
+    {
+        $this->analysisProcess = null;
+
+        // 解析帮助信息中的参数
+        $this->parseHelpOutput($helpOutput);
+
+        // 如果仍然没有参数，添加一个默认参数用于测试
+        if (empty($this->cliParameters)) {
+            $this->appendOutput("未检测到参数，添加默认参数用于测试\n");
+            $this->cliParameters['test'] = [
+                'name' => 'test',
+                'short' => null,
+                'description' => '测试参数',
+                'required' => false,
+                'type' => 'string',
+                'default' => ''
+            ];
+        }
+
+        $this->appendOutput("退出 parseCliParametersByExecution 方法\n");
+        $onDone();
+    }
+
     private function parseHelpOutput($helpOutput)
     {
         if (empty($helpOutput)) {
@@ -1199,6 +1164,7 @@ class IntelligentPackagerTab
             $appVersion = Entry::text($this->appVersionEntry);
             $includeVendor = Checkbox::checked($this->includeVendorCheckbox);
             $includePhar = Checkbox::checked($this->includePharCheckbox);
+            $incremental = Checkbox::checked($this->incrementalCheckbox);
 
             // 验证必需参数
             if (empty($sourceFile)) {
@@ -1221,9 +1187,9 @@ class IntelligentPackagerTab
                 return;
             }
 
-            // 检查目标目录是否存在，如果存在则提示用户确认
+            // 检查目标目录是否存在，如果存在则提示用户确认（增量打包会复用该目录）
             $appOutputDir = $outputDir . '/' . $appName;
-            if (is_dir($appOutputDir)) {
+            if (is_dir($appOutputDir) && !$incremental) {
                 // 获取主窗口引用
                 global $application;
                 $window = $application->getWindow();
@@ -1246,8 +1212,8 @@ class IntelligentPackagerTab
             MultilineEntry::setText($this->outputArea, "开始打包...\n");
 
             // 使用 LibuiApp::queueMain 异步执行打包操作
-            LibuiApp::queueMain(function() use ($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar) {
-                $this->executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar);
+            LibuiApp::queueMain(function() use ($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar, $incremental) {
+                $this->executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar, $incremental);
             });
 
         } catch (\Exception $e) {
@@ -1266,7 +1232,7 @@ class IntelligentPackagerTab
         }
     }
 
-    private function executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar)
+    private function executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar, $incremental)
     {
         // 第一步：分析项目结构和创建目录
         $this->appendOutput("正在分析项目结构...\n");
@@ -1275,10 +1241,16 @@ class IntelligentPackagerTab
         // 根据应用名称创建独立的目录
         $appOutputDir = $outputDir . '/' . $appName;
 
-        // 如果目录已存在，先删除它
-        if (is_dir($appOutputDir)) {
+        // 打包清单保存在应用目录之外，不会进入压缩包
+        $this->builder = new IncrementalBuilder($outputDir . '/.' . $appName . '.build');
+
+        if ($incremental) {
+            $this->appendOutput("增量打包：只处理变化的文件\n");
+        } elseif (is_dir($appOutputDir)) {
+            // 如果目录已存在，先删除它
             $this->appendOutput("删除已存在的目录: $appOutputDir\n");
             $this->deleteDirectory($appOutputDir);
+            $this->builder->reset();
         }
 
         // 创建新的目录
@@ -1300,7 +1272,7 @@ class IntelligentPackagerTab
         // 第二步：复制源文件
         $this->appendOutput("复制源文件...\n");
         $targetSource = $appOutputDir . '/' . basename($sourceFile);
-        copy($sourceFile, $targetSource);
+        $this->builder->syncFile($sourceFile, $targetSource, basename($sourceFile));
         ProgressBar::setValue($this->progressBar, 30);
 
         // 使用 queueMain 调用下一步
@@ -1314,9 +1286,17 @@ class IntelligentPackagerTab
         // 第三步：复制 vendor 目录
         if ($includeVendor && is_dir('vendor')) {
             $this->appendOutput("复制 vendor 目录...\n");
-            $this->copyDirectory('vendor', $appOutputDir . '/vendor');
+            $this->builder->syncDirectory('vendor', $appOutputDir . '/vendor', 'vendor');
+            $stats = $this->builder->getStats();
+            $this->appendOutput(sprintf("  未变化 %d 个，链接 %d 个，复制 %d 个，删除 %d 个\n",
+                $stats['unchanged'], $stats['linked'], $stats['copied'], $stats['removed']));
             ProgressBar::setValue($this->progressBar, 50);
         } else {
+            // 增量打包时删除上一次留下的 vendor 目录
+            if (is_dir($appOutputDir . '/vendor')) {
+                $this->deleteDirectory($appOutputDir . '/vendor');
+            }
+            $this->builder->forget('vendor');
             ProgressBar::setValue($this->progressBar, 50);
         }
 
@@ -1385,25 +1365,24 @@ class IntelligentPackagerTab
     private function createPharFile($sourceFile, $pharFile, $includeVendor)
     {
         try {
-            // 创建 PHAR 文件
-            $phar = new \Phar($pharFile);
-            $phar->startBuffering();
-
             // 添加源文件
-            $phar->addFile($sourceFile, basename($sourceFile));
+            $entries = [basename($sourceFile) => $sourceFile];
 
-            // 如果需要包含 vendor 目录
+            // 如果需要包含 vendor 目录（条目相对于 vendor 目录）
             if ($includeVendor && is_dir('vendor')) {
                 $this->appendOutput("  添加 vendor 目录到 PHAR...\n");
-                $phar->buildFromDirectory('vendor', '/vendor/');
+                $entries += IncrementalBuilder::listFiles('vendor');
             }
 
             // 设置默认运行脚本
-            $phar->setStub("#!/usr/bin/env php\n<?php\nPhar::mapPhar();\ninclude 'phar://".basename($pharFile)."/".basename($sourceFile)."';\n__HALT_COMPILER();\n");
+            $stub = "#!/usr/bin/env php\n<?php\nPhar::mapPhar();\ninclude 'phar://".basename($pharFile)."/".basename($sourceFile)."';\n__HALT_COMPILER();\n";
 
-            $phar->stopBuffering();
+            // 只写入变化的条目
+            $this->builder->buildPhar($pharFile, $entries, $stub);
 
-            $this->appendOutput("  PHAR 文件创建完成: $pharFile\n");
+            $stats = $this->builder->getStats();
+            $this->appendOutput(sprintf("  PHAR 文件创建完成: %s（新增 %d 个条目，复用 %d 个，删除 %d 个）\n",
+                $pharFile, $stats['phar_added'], $stats['phar_reused'], $stats['phar_removed']));
         } catch (\Exception $e) {
             $this->appendOutput("  创建 PHAR 文件时出错: " . $e->getMessage() . "\n");
         }
@@ -1666,42 +1645,17 @@ EOT;
         $this->appendOutput("  创建源码压缩包: $zipFile\n");
 
         try {
-            // 创建ZIP压缩包
-            $zip = new \ZipArchive();
-            if ($zip->open($zipFile, \ZipArchive::CREATE | \ZipArchive::OVERWRITE) === TRUE) {
-                // 添加应用目录中的所有文件
-                $this->addFilesToZip($zip, $outputDir, $outputDir);
-                $zip->close();
-                $this->appendOutput("  源码压缩包创建完成: $zipFile\n");
-            } else {
-                $this->appendOutput("  创建源码压缩包失败\n");
-            }
+            // 添加应用目录中的所有文件，未变化的条目直接复用上一次的压缩数据
+            $this->builder->buildZip($zipFile, $outputDir);
+            $stats = $this->builder->getStats();
+            $this->appendOutput(sprintf("  源码压缩包创建完成: %s（压缩 %d 个文件，复用 %d 个）\n",
+                $zipFile, $stats['zip_compressed'], $stats['zip_reused']));
         } catch (\Exception $e) {
             $this->appendOutput("  创建源码压缩包时出错: " . $e->getMessage() . "\n");
         }
-    }
-
-    private function addFilesToZip($zip, $basePath, $dir)
-    {
-        $files = scandir($dir);
-        foreach ($files as $file) {
-            if ($file === '.' || $file === '..') {
-                continue;
-            }
 
-            $filePath = $dir . '/' . $file;
-            $relativePath = substr($filePath, strlen($basePath) + 1);
-
-            if (is_dir($filePath)) {
-                // 添加目录
-                $zip->addEmptyDir($relativePath);
-                // 递归添加子目录
-                $this->addFilesToZip($zip, $basePath, $filePath);
-            } else {
-                // 添加文件
-                $zip->addFile($filePath, $relativePath);
-            }
-        }
+        // 保存打包清单，供下一次增量打包使用
+        $this->builder->save();
     }
 
     private function deleteDirectory($dir)
@@ -1722,23 +1676,6 @@ EOT;
         rmdir($dir);
     }
 
-    private function copyDirectory($src, $dst)
-    {
-        $dir = opendir($src);
-        @mkdir($dst);
-        while(false !== ( $file = readdir($dir)) ) {
-            if (( $file != '.' ) && ( $file != '..' )) {
-                if ( is_dir($src . '/' . $file) ) {
-                    $this->copyDirectory($src . '/' . $file, $dst . '/' . $file);
-                }
-                else {
-                    copy($src . '/' . $file, $dst . '/' . $file);
-                }
-            }
-        }
-        closedir($dir);
-    }
-
     private function openOutputDirectory()
     {
         try {
@@ -1781,15 +1718,16 @@ EOT;
     {
         try {
             // 跨平台打开目录
+            // 异步启动，不等待文件管理器退出
             if (PHP_OS_FAMILY === 'Windows') {
                 // Windows 系统
-                shell_exec('explorer "' . str_replace('/', '\\', $path) . '"');
+                (new LibuiProcess(['explorer', str_replace('/', '\\', $path)]))->start();
             } else if (PHP_OS_FAMILY === 'Darwin') {
                 // macOS 系统
-                shell_exec('open "' . $path . '"');
+                (new LibuiProcess(['open', $path]))->start();
             } else if (PHP_OS_FAMILY === 'Linux') {
                 // Linux 系统
-                shell_exec('xdg-open "' . $path . '"');
+                (new LibuiProcess(['xdg-open', $path]))->start();
             } else {
                 // 其他系统
                 $this->appendOutput("不支持的操作系统: " . PHP_OS_FAMILY . "\n");
@@ -1811,15 +1749,12 @@ EOT;
         
         // 如果有临时输出内容，先输出临时内容
         if (!empty($this->tempOutput)) {
-            $currentText = MultilineEntry::text($this->outputArea);
-            $newText = $currentText . $this->tempOutput;
-            MultilineEntry::setText($this->outputArea, $newText);
+            MultilineEntry::append($this->outputArea, $this->tempOutput);
             $this->tempOutput = ''; // 清空临时输出
         }
         
-        $currentText = MultilineEntry::text($this->outputArea);
-        $newText = $currentText . $text;
-        MultilineEntry::setText($this->outputArea, $newText);
+        // 直接追加，避免每次读取并重设全部文本
+        MultilineEntry::append($this->outputArea, $text);
 
         // 滚动到底部（如果可能的话）
         // 注意：libui PHP绑定可能不支持直接滚动到底部
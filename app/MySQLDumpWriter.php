@@ -0,0 +1,188 @@
+<?php
+
+namespace App;
+
+/**
+ * 把转换结果写成导出文件，不需要 MySQL 服务
+ *
+ * 每张表一个文件，多个工作进程可以同时写入不同的表：
+ * - sql 格式：<表>.sql，包含建表语句和多行 INSERT
+ * - tsv 格式：<表>.tsv 为 LOAD DATA 默认格式的数据，<表>.sql 包含建表语句和 LOAD DATA 语句
+ *
+ * writeIndex() 生成 import.sql，在导出目录中用 mysql 客户端执行即可导入全部表。
+ */
+class MySQLDumpWriter implements MySQLWriter
+{
+    public const FORMAT_SQL = 'sql';
+    public const FORMAT_TSV = 'tsv';
+
+    // MySQL 字符串字面量转义
+    private const SQL_ESCAPES = ["\\" => "\\\\", "'" => "\\'", "\0" => "\\0", "\n" => "\\n", "\r" => "\\r", "\x1a" => "\\Z"];
+    // LOAD DATA 默认格式（FIELDS ESCAPED BY '\\'）的转义
+    private const TSV_ESCAPES = ["\\" => "\\\\", "\t" => "\\t", "\n" => "\\n", "\r" => "\\r", "\0" => "\\0"];
+
+    private string $directory;
+    private string $format;
+
+    private $schemaHandle = null;
+    private $dataHandle = null;
+    private string $insertPrefix = '';
+    private array $binaryColumns = [];
+
+    public function __construct(string $directory, string $format = self::FORMAT_SQL)
+    {
+        if (!in_array($format, [self::FORMAT_SQL, self::FORMAT_TSV], true)) {
+            throw new \InvalidArgumentException("不支持的导出格式: $format");
+        }
+        if (!is_dir($directory) && !mkdir($directory, 0755, true) && !is_dir($directory)) {
+            throw new \RuntimeException("无法创建导出目录: $directory");
+        }
+        $this->directory = rtrim($directory, '/\\');
+        $this->format = $format;
+    }
+
+    /**
+     * 表对应的文件名（不含扩展名）
+     */
+    public static function baseName(string $table): string
+    {
+        return preg_replace('/[^A-Za-z0-9_.-]/', '_', $table);
+    }
+
+    /**
+     * 生成按顺序导入所有表的 import.sql
+     */
+    public static function writeIndex(string $directory, array $tables): string
+    {
+        $index = "SET NAMES utf8mb4;\nSET FOREIGN_KEY_CHECKS=0;\n";
+        foreach ($tables as $table) {
+            $index .= "SOURCE " . self::baseName($table) . ".sql;\n";
+        }
+        $path = rtrim($directory, '/\\') . '/import.sql';
+        file_put_contents($path, $index);
+        return $path;
+    }
+
+    public function beginTable(string $table, string $createSql, array $columns, bool $dropExisting): void
+    {
+        $base = $this->directory . '/' . self::baseName($table);
+        $this->schemaHandle = fopen($base . '.sql', 'wb');
+        if ($this->schemaHandle === false) {
+            throw new \RuntimeException("无法写入文件: $base.sql");
+        }
+
+        $quoted = SQLiteToMySQLConverter::quoteIdentifier($table);
+        $names = implode(',', array_map([SQLiteToMySQLConverter::class, 'quoteIdentifier'], array_keys($columns)));
+
+        $header = "SET NAMES utf8mb4;\nSET FOREIGN_KEY_CHECKS=0;\n";
+        if ($dropExisting) {
+            $header .= "DROP TABLE IF EXISTS $quoted;\n";
+        }
+        $header .= $createSql . ";\n";
+
+        if ($this->format === self::FORMAT_TSV) {
+            // 路径相对于执行 mysql 客户端时的当前目录
+            $header .= "LOAD DATA LOCAL INFILE '" . strtr(self::baseName($table) . '.tsv', self::SQL_ESCAPES) . "'"
+                . " INTO TABLE $quoted CHARACTER SET utf8mb4 ($names);\n";
+            $this->dataHandle = fopen($base . '.tsv', 'wb');
+            if ($this->dataHandle === false) {
+                throw new \RuntimeException("无法写入文件: $base.tsv");
+            }
+        } else {
+            $this->insertPrefix = "INSERT INTO $quoted ($names) VALUES\n";
+            $this->binaryColumns = [];
+            foreach (array_values($columns) as $index => $type) {
+                if (str_contains($type, 'BLOB') || str_contains($type, 'BINARY')) {
+                    $this->binaryColumns[$index] = true;
+                }
+            }
+        }
+        fwrite($this->schemaHandle, $header);
+    }
+
+    public function writeRows(array $rows): void
+    {
+        if (empty($rows)) {
+            return;
+        }
+
+        if ($this->format === self::FORMAT_TSV) {
+            $lines = '';
+            foreach ($rows as $row) {
+                $fields = [];
+                foreach ($row as $value) {
+                    if ($value === null) {
+                        $fields[] = '\\N';
+                    } elseif (is_float($value)) {
+                        $fields[] = is_finite($value) ? $this->floatLiteral($value) : '\\N';
+                    } else {
+                        $fields[] = strtr((string)$value, self::TSV_ESCAPES);
+                    }
+                }
+                $lines .= implode("\t", $fields) . "\n";
+            }
+            fwrite($this->dataHandle, $lines);
+            return;
+        }
+
+        $values = [];
+        foreach ($rows as $row) {
+            $literals = [];
+            foreach ($row as $index => $value) {
+                $literals[] = $this->literal($value, isset($this->binaryColumns[$index]));
+            }
+            $values[] = '(' . implode(',', $literals) . ')';
+        }
+        fwrite($this->schemaHandle, $this->insertPrefix . implode(",\n", $values) . ";\n");
+    }
+
+    public function endTable(): void
+    {
+        if ($this->schemaHandle !== null) {
+            fclose($this->schemaHandle);
+            $this->schemaHandle = null;
+        }
+        if ($this->dataHandle !== null) {
+            fclose($this->dataHandle);
+            $this->dataHandle = null;
+        }
+    }
+
+    /**
+     * 关闭文件；已写入的部分保留，导入前需要重新转换这张表
+     */
+    public function abortTable(): void
+    {
+        $this->endTable();
+    }
+
+    public function close(): void
+    {
+        $this->endTable();
+    }
+
+    private function literal(mixed $value, bool $binary): string
+    {
+        if ($value === null) {
+            return 'NULL';
+        }
+        if (is_int($value)) {
+            return (string)$value;
+        }
+        if (is_float($value)) {
+            return is_finite($value) ? $this->floatLiteral($value) : 'NULL';
+        }
+        if ($binary) {
+            return $value === '' ? "''" : '0x' . bin2hex($value);
+        }
+        return "'" . strtr((string)$value, self::SQL_ESCAPES) . "'";
+    }
+
+    /**
+     * 浮点数的最短无损表示（(string) 转换受 precision 配置影响会丢失精度）
+     */
+    private function floatLiteral(float $value): string
+    {
+        return json_encode($value);
+    }
+}
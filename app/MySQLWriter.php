@@ -0,0 +1,35 @@
+<?php
+
+namespace App;
+
+/**
+ * SQLite 到 MySQL 转换的输出目标（MySQL 连接或导出文件）
+ *
+ * 每个工作进程各自创建一个实例，按表依次调用 beginTable / writeRows / endTable。
+ */
+interface MySQLWriter
+{
+    /**
+     * 开始写入一张表
+     *
+     * @param string $table 表名
+     * @param string $createSql MySQL 建表语句
+     * @param array $columns 列名 => MySQL 类型
+     * @param bool $dropExisting 是否先删除已存在的表
+     */
+    public function beginTable(string $table, string $createSql, array $columns, bool $dropExisting): void;
+
+    /**
+     * 写入一批行，每行是按列顺序排列的值
+     */
+    public function writeRows(array $rows): void;
+
+    public function endTable(): void;
+
+    /**
+     * 当前表写入失败：丢弃尚未提交的数据并结束这张表
+     */
+    public function abortTable(): void;
+
+    public function close(): void;
+}
@@ -23,6 +23,7 @@ class PHPFpmCalculatorTab
     private LibuiLabel $minSpareServersLabel;
     private LibuiLabel $maxSpareServersLabel;
     private LibuiMultilineEntry $configOutput;
+    private ?array $lastInputs = null; // 上次计算时的滑块值
 
     public function __construct()
     {
@@ -161,22 +162,12 @@ class PHPFpmCalculatorTab
 
     private function addEventHandlers()
     {
-        // Add event handlers for slider changes
-        $this->totalRamSlider->onChange(function () {
-            $this->calculate();
-        });
-
-        $this->reservedRamSlider->onChange(function () {
-            $this->calculate();
-        });
-
-        $this->ramBufferSlider->onChange(function () {
-            $this->calculate();
-        });
-
-        $this->processSizeSlider->onChange(function () {
-            $this->calculate();
-        });
+        // 拖动滑块时每个像素都会触发 changed，合并到同一轮主循环只计算一次
+        foreach ([$this->totalRamSlider, $this->reservedRamSlider, $this->ramBufferSlider, $this->processSizeSlider] as $slider) {
+            $slider->onCoalesced('slider.changed', function () {
+                $this->calculate();
+            });
+        }
     }
 
     private function initializeDefaultValues()
@@ -198,6 +189,13 @@ class PHPFpmCalculatorTab
             $ramBufferPercent = $this->ramBufferSlider->getValue();
             $processSizeMb = $this->processSizeSlider->getValue();
 
+            // 输入没有变化时不重新生成配置
+            $inputs = [$totalRamGb, $reservedRamGb, $ramBufferPercent, $processSizeMb];
+            if ($inputs === $this->lastInputs) {
+                return;
+            }
+            $this->lastInputs = $inputs;
+
             // Validate inputs
             if ($processSizeMb <= 0) {
                 $this->setErrorResult("进程大小必须大于0");
@@ -230,6 +228,7 @@ class PHPFpmCalculatorTab
             $this->configOutput->setText($configText);
 
         } catch (\Exception $e) {
+            $this->lastInputs = null;
             $this->setErrorResult("计算错误: " . $e->getMessage());
         }
     }
@@ -11,6 +11,7 @@ use Kingbes\Libui\SDK\LibuiMultilineEntry;
 use Kingbes\Libui\SDK\LibuiProgressBar;
 use Kingbes\Libui\SDK\LibuiCheckbox;
 use Kingbes\Libui\SDK\LibuiApplication;
+use Kingbes\Libui\SDK\LibuiProcess;
 use Kingbes\Libui\Window;
 
 class PackagerTab
@@ -22,6 +23,8 @@ class PackagerTab
     private LibuiEntry $appVersionEntry;
     private LibuiCheckbox $includeVendorCheckbox;
     private LibuiCheckbox $includePharCheckbox;
+    private LibuiCheckbox $incrementalCheckbox;
+    private ?IncrementalBuilder $builder = null;
     private LibuiMultilineEntry $outputArea;
     private LibuiProgressBar $progressBar;
     private LibuiButton $packageButton;
@@ -135,6 +138,11 @@ class PackagerTab
         $this->includePharCheckbox->setChecked(true);
         $inputBox->append($this->includePharCheckbox, false);
 
+        // 增量打包复选框
+        $this->incrementalCheckbox = new LibuiCheckbox("增量打包（复用未变化的文件）");
+        $this->incrementalCheckbox->setChecked(true);
+        $inputBox->append($this->incrementalCheckbox, false);
+
         // 按钮容器
         $buttonBox = new \Kingbes\Libui\SDK\LibuiHBox();
         $buttonBox->setPadded(true);
@@ -243,6 +251,7 @@ class PackagerTab
             $appVersion = $this->appVersionEntry->getText();
             $includeVendor = $this->includeVendorCheckbox->isChecked();
             $includePhar = $this->includePharCheckbox->isChecked();
+            $incremental = $this->incrementalCheckbox->isChecked();
 
             // 验证必需参数
             if (empty($sourceFile)) {
@@ -265,9 +274,9 @@ class PackagerTab
                 return;
             }
 
-            // 检查目标目录是否存在，如果存在则提示用户确认
+            // 检查目标目录是否存在，如果存在则提示用户确认（增量打包会复用该目录）
             $appOutputDir = $outputDir . '/' . $appName;
-            if (is_dir($appOutputDir)) {
+            if (is_dir($appOutputDir) && !$incremental) {
                 // 获取主窗口引用
                 global $application;
                 $window = $application->getWindow();
@@ -290,8 +299,8 @@ class PackagerTab
             $this->outputArea->setText("开始打包...\n");
 
             // 使用 LibuiApplication::queueMain 异步执行打包操作
-            LibuiApplication::getInstance()->queueMain(function() use ($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar) {
-                $this->executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar);
+            LibuiApplication::getInstance()->queueMain(function() use ($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar, $incremental) {
+                $this->executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar, $incremental);
             });
 
         } catch (\Exception $e) {
@@ -310,7 +319,7 @@ class PackagerTab
         }
     }
 
-    private function executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar)
+    private function executePackagingStep1($sourceFile, $outputDir, $appName, $appVersion, $includeVendor, $includePhar, $incremental)
     {
         // 第一步：分析项目结构和创建目录
         $this->appendOutput("正在分析项目结构...\n");
@@ -319,10 +328,16 @@ class PackagerTab
         // 根据应用名称创建独立的目录
         $appOutputDir = $outputDir . '/' . $appName;
 
-        // 如果目录已存在，先删除它
-        if (is_dir($appOutputDir)) {
+        // 打包清单保存在应用目录之外，不会进入压缩包
+        $this->builder = new IncrementalBuilder($outputDir . '/.' . $appName . '.build');
+
+        if ($incremental) {
+            $this->appendOutput("增量打包：只处理变化的文件\n");
+        } elseif (is_dir($appOutputDir)) {
+            // 如果目录已存在，先删除它
             $this->appendOutput("删除已存在的目录: $appOutputDir\n");
             $this->deleteDirectory($appOutputDir);
+            $this->builder->reset();
         }
 
         // 创建新的目录
@@ -344,7 +359,7 @@ class PackagerTab
         // 第二步：复制源文件
         $this->appendOutput("复制源文件...\n");
         $targetSource = $appOutputDir . '/' . basename($sourceFile);
-        copy($sourceFile, $targetSource);
+        $this->builder->syncFile($sourceFile, $targetSource, basename($sourceFile));
         $this->progressBar->setValue(30);
 
         // 使用 queueMain 调用下一步
@@ -358,9 +373,17 @@ class PackagerTab
         // 第三步：复制 vendor 目录
         if ($includeVendor && is_dir('vendor')) {
             $this->appendOutput("复制 vendor 目录...\n");
-            $this->copyDirectory('vendor', $appOutputDir . '/vendor');
+            $this->builder->syncDirectory('vendor', $appOutputDir . '/vendor', 'vendor');
+            $stats = $this->builder->getStats();
+            $this->appendOutput(sprintf("  未变化 %d 个，链接 %d 个，复制 %d 个，删除 %d 个\n",
+                $stats['unchanged'], $stats['linked'], $stats['copied'], $stats['removed']));
             $this->progressBar->setValue(50);
         } else {
+            // 增量打包时删除上一次留下的 vendor 目录
+            if (is_dir($appOutputDir . '/vendor')) {
+                $this->deleteDirectory($appOutputDir . '/vendor');
+            }
+            $this->builder->forget('vendor');
             $this->progressBar->setValue(50);
         }
 
@@ -429,25 +452,24 @@ class PackagerTab
     private function createPharFile($sourceFile, $pharFile, $includeVendor)
     {
         try {
-            // 创建 PHAR 文件
-            $phar = new \Phar($pharFile);
-            $phar->startBuffering();
-
             // 添加源文件
-            $phar->addFile($sourceFile, basename($sourceFile));
+            $entries = [basename($sourceFile) => $sourceFile];
 
-            // 如果需要包含 vendor 目录
+            // 如果需要包含 vendor 目录（条目相对于 vendor 目录）
             if ($includeVendor && is_dir('vendor')) {
                 $this->appendOutput("  添加 vendor 目录到 PHAR...\n");
-                $phar->buildFromDirectory('vendor', '/vendor/');
+                $entries += IncrementalBuilder::listFiles('vendor');
             }
 
             // 设置默认运行脚本
-            $phar->setStub("#!/usr/bin/env php\n<?php\nPhar::mapPhar();\ninclude 'phar://".basename($pharFile)."/".basename($sourceFile)."';\n__HALT_COMPILER();\n");
+            $stub = "#!/usr/bin/env php\n<?php\nPhar::mapPhar();\ninclude 'phar://".basename($pharFile)."/".basename($sourceFile)."';\n__HALT_COMPILER();\n";
 
-            $phar->stopBuffering();
+            // 只写入变化的条目
+            $this->builder->buildPhar($pharFile, $entries, $stub);
 
-            $this->appendOutput("  PHAR 文件创建完成: $pharFile\n");
+            $stats = $this->builder->getStats();
+            $this->appendOutput(sprintf("  PHAR 文件创建完成: %s（新增 %d 个条目，复用 %d 个，删除 %d 个）\n",
+                $pharFile, $stats['phar_added'], $stats['phar_reused'], $stats['phar_removed']));
         } catch (\Exception $e) {
             $this->appendOutput("  创建 PHAR 文件时出错: " . $e->getMessage() . "\n");
         }
@@ -523,7 +545,19 @@ EOT;
         // 创建源码压缩包的逻辑
         $zipFile = $outputDir . '/' . $appName . '_source.zip';
         $this->appendOutput("  源码包将保存为: $zipFile\n");
-        // 实际的 ZIP 创建逻辑会在这里实现
+
+        try {
+            // 添加应用目录中的所有文件，未变化的条目直接复用上一次的压缩数据
+            $this->builder->buildZip($zipFile, $outputDir);
+            $stats = $this->builder->getStats();
+            $this->appendOutput(sprintf("  源码压缩包创建完成（压缩 %d 个文件，复用 %d 个）\n",
+                $stats['zip_compressed'], $stats['zip_reused']));
+        } catch (\Exception $e) {
+            $this->appendOutput("  创建源码压缩包时出错: " . $e->getMessage() . "\n");
+        }
+
+        // 保存打包清单，供下一次增量打包使用
+        $this->builder->save();
     }
 
     private function deleteDirectory($dir)
@@ -544,23 +578,6 @@ EOT;
         rmdir($dir);
     }
 
-    private function copyDirectory($src, $dst)
-    {
-        $dir = opendir($src);
-        @mkdir($dst);
-        while(false !== ( $file = readdir($dir)) ) {
-            if (( $file != '.' ) && ( $file != '..' )) {
-                if ( is_dir($src . '/' . $file) ) {
-                    $this->copyDirectory($src . '/' . $file, $dst . '/' . $file);
-                }
-                else {
-                    copy($src . '/' . $file, $dst . '/' . $file);
-                }
-            }
-        }
-        closedir($dir);
-    }
-
     private function openOutputDirectory()
     {
         try {
@@ -603,15 +620,16 @@ EOT;
     {
         try {
             // 跨平台打开目录
+            // 异步启动，不等待文件管理器退出
             if (PHP_OS_FAMILY === 'Windows') {
                 // Windows 系统
-                shell_exec('explorer "' . str_replace('/', '\\', $path) . '"');
+                (new LibuiProcess(['explorer', str_replace('/', '\\', $path)]))->start();
             } else if (PHP_OS_FAMILY === 'Darwin') {
                 // macOS 系统
-                shell_exec('open "' . $path . '"');
+                (new LibuiProcess(['open', $path]))->start();
             } else if (PHP_OS_FAMILY === 'Linux') {
                 // Linux 系统
-                shell_exec('xdg-open "' . $path . '"');
+                (new LibuiProcess(['xdg-open', $path]))->start();
             } else {
                 // 其他系统
                 throw new \Exception("不支持的操作系统: " . PHP_OS_FAMILY);
@@ -623,9 +641,7 @@ EOT;
 
     private function appendOutput($text)
     {
-        $currentText = $this->outputArea->getText();
-        $newText = $currentText . $text;
-        $this->outputArea->setText($newText);
+        $this->outputArea->append($text);
     }
 
     public function getControl()
@@ -0,0 +1,212 @@
+<?php
+
+namespace App;
+
+use Kingbes\Libui\SDK\LibuiApplication;
+use Kingbes\Libui\SDK\LibuiButton;
+use Kingbes\Libui\SDK\LibuiDrawArea;
+use Kingbes\Libui\SDK\LibuiHBox;
+use Kingbes\Libui\SDK\LibuiLabel;
+use Kingbes\Libui\SDK\LibuiProfiler;
+use Kingbes\Libui\SDK\LibuiScene;
+use Kingbes\Libui\SDK\LibuiSceneNode;
+use Kingbes\Libui\SDK\LibuiSpinbox;
+use Kingbes\Libui\SDK\LibuiTable;
+use Kingbes\Libui\SDK\LibuiVBox;
+
+/**
+ * 性能标签页：显示 LibuiProfiler 记录的回调耗时
+ *
+ * 每秒刷新一次汇总表和耗时直方图；选中表格中的一行时只显示该回调的直方图。
+ * 需要以 php cli.php gui --profile 启动。
+ */
+class PerformanceTab
+{
+    private const HISTOGRAM_WIDTH = 600;
+    private const HISTOGRAM_HEIGHT = 140;
+
+    private LibuiVBox $box;
+    private LibuiProfiler $profiler;
+    private LibuiLabel $statusLabel;
+    private LibuiLabel $histogramLabel;
+    private LibuiTable $table;
+    private LibuiScene $histogram;
+    private LibuiSpinbox $thresholdSpinbox;
+    private array $rowNames = []; // 表格行号 => 回调名称
+    private ?string $selected = null;
+    private string $message = '';
+
+    public function __construct()
+    {
+        $this->profiler = LibuiApplication::getInstance()->getProfiler();
+
+        $this->box = new LibuiVBox();
+        $this->box->setPadded(true);
+
+        $this->addToolbar($this->box);
+        $this->addHistogram($this->box);
+        $this->addStatsTable($this->box);
+
+        $this->refresh();
+        LibuiApplication::getInstance()->timer(1000, function () {
+            $this->refresh();
+            return true;
+        });
+    }
+
+    private function addToolbar(LibuiVBox $container)
+    {
+        $toolbar = new LibuiHBox();
+        $toolbar->setPadded(true);
+        $container->append($toolbar, false);
+
+        $toolbar->append(new LibuiLabel("阻塞阈值 (ms):"), false);
+        $this->thresholdSpinbox = new LibuiSpinbox(1, 1000);
+        $this->thresholdSpinbox->setValue((int)round($this->profiler->getThreshold()));
+        $this->thresholdSpinbox->onChange(function ($spinbox, $value) {
+            $this->profiler->setThreshold((float)$value);
+        });
+        $toolbar->append($this->thresholdSpinbox, false);
+
+        $exportButton = new LibuiButton("导出 Chrome Trace");
+        $exportButton->onClick(function () {
+            $this->exportTrace();
+        });
+        $toolbar->append($exportButton, false);
+
+        $clearButton = new LibuiButton("清空");
+        $clearButton->onClick(function () {
+            $this->profiler->clear();
+            $this->message = '';
+            $this->refresh();
+        });
+        $toolbar->append($clearButton, false);
+
+        $this->statusLabel = new LibuiLabel($this->profiler->isEnabled() ? "" : "性能分析未启用，请以 php cli.php gui --profile 启动");
+        $container->append($this->statusLabel, false);
+    }
+
+    private function addHistogram(LibuiVBox $container)
+    {
+        // 每个桶一个柱子，刷新时只修改柱子的高度
+        $this->histogram = new LibuiScene();
+        for ($i = 0; $i < LibuiProfiler::BUCKETS; $i++) {
+            $this->histogram->add(new LibuiSceneNode(), "bar$i");
+        }
+        $area = new LibuiDrawArea(self::HISTOGRAM_WIDTH, self::HISTOGRAM_HEIGHT);
+        $area->setScene($this->histogram);
+        // 普通绘图区域没有最小高度，和表格一起按比例分配剩余空间
+        $container->append($area, true);
+
+        $this->histogramLabel = new LibuiLabel("");
+        $container->append($this->histogramLabel, false);
+    }
+
+    private function addStatsTable(LibuiVBox $container)
+    {
+        $this->table = new LibuiTable();
+        $this->table->addTextColumn("回调", 0)
+            ->addTextColumn("类别", 1)
+            ->addTextColumn("次数", 2)
+            ->addTextColumn("平均 ms", 3)
+            ->addTextColumn("P95 ms", 4)
+            ->addTextColumn("最大 ms", 5)
+            ->addTextColumn("超时", 6)
+            ->addTextColumn("FFI/次", 7)
+            ->addTextColumn("内存 KB/次", 8);
+
+        $this->table->onSelectionChanged(function ($selectedRow) {
+            $this->selected = $this->rowNames[$selectedRow] ?? null;
+            $this->updateHistogram();
+        });
+
+        $container->append($this->table, true);
+    }
+
+    private function refresh()
+    {
+        $stats = $this->profiler->getStats();
+        $rows = [];
+        $this->rowNames = [];
+        foreach ($stats as $stat) {
+            $this->rowNames[] = $stat['name'];
+            $rows[] = [
+                $stat['name'],
+                $stat['category'],
+                (string)$stat['count'],
+                number_format($stat['avg_ms'], 3),
+                number_format($stat['p95_ms'], 3),
+                number_format($stat['max_ms'], 2),
+                (string)$stat['slow'],
+                number_format($stat['ffi_calls'], 1),
+                number_format($stat['memory'] / 1024, 1),
+            ];
+        }
+        $this->table->setData($rows);
+
+        if ($this->profiler->isEnabled()) {
+            $status = sprintf("已记录 %d 个回调，超过 %.0f ms 的调用 %d 次", count($stats), $this->profiler->getThreshold(), $this->profiler->getSlowCount());
+            $slow = $this->profiler->getSlowCalls();
+            if (!empty($slow)) {
+                $last = end($slow);
+                $status .= sprintf("，最近一次：%s %.1f ms", $last['name'], $last['ms']);
+            }
+            if ($this->message !== '') {
+                $status .= "\n" . $this->message;
+            }
+            $this->statusLabel->setText($status);
+        }
+
+        $this->updateHistogram();
+    }
+
+    /**
+     * 横轴为对数刻度的耗时桶，纵轴按最高的桶归一化；超过阈值的桶标红
+     */
+    private function updateHistogram()
+    {
+        $buckets = $this->profiler->getHistogram($this->selected);
+        $peak = max(1, max($buckets));
+        $barWidth = self::HISTOGRAM_WIDTH / LibuiProfiler::BUCKETS;
+        $threshold = $this->profiler->getThreshold();
+
+        foreach ($buckets as $i => $count) {
+            $height = $count > 0 ? max(1, (self::HISTOGRAM_HEIGHT - 4) * $count / $peak) : 0;
+            $bar = $this->histogram->get("bar$i");
+            $bar->clear();
+            if ($height > 0) {
+                $bar->rectangle($i * $barWidth + 1, self::HISTOGRAM_HEIGHT - $height, $barWidth - 2, $height);
+            }
+            // 桶的下界超过阈值时整个桶都是慢调用
+            if (LibuiProfiler::bucketUpperMs($i) / 2 >= $threshold) {
+                $bar->setFill(0.85, 0.25, 0.2);
+            } else {
+                $bar->setFill(0.2, 0.5, 0.9);
+            }
+        }
+
+        $this->histogramLabel->setText(sprintf(
+            "%s：共 %d 次，横轴从左到右每格耗时翻倍（< 2 µs … ≥ %.0f ms），红色为超过阈值的区间",
+            $this->selected ?? "全部回调",
+            array_sum($buckets),
+            LibuiProfiler::bucketUpperMs(LibuiProfiler::BUCKETS - 2)
+        ));
+    }
+
+    private function exportTrace()
+    {
+        $file = sys_get_temp_dir() . DIRECTORY_SEPARATOR . 'php-tools-trace-' . date('Ymd-His') . '.json';
+        try {
+            $this->profiler->exportChromeTrace($file);
+            $this->message = "已导出到 $file（可在 chrome://tracing 或 ui.perfetto.dev 中打开）";
+        } catch (\Throwable $e) {
+            $this->message = "导出失败: " . $e->getMessage();
+        }
+        $this->refresh();
+    }
+
+    public function getControl()
+    {
+        return $this->box;
+    }
+}
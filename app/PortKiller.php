@@ -9,6 +9,7 @@ use Kingbes\Libui\SDK\LibuiEntry;
 use Kingbes\Libui\SDK\LibuiLabel;
 use Kingbes\Libui\SDK\LibuiTable;
 use Kingbes\Libui\SDK\LibuiApplication;
+use Kingbes\Libui\SDK\LibuiProcess;
 
 class PortKiller
 {
@@ -19,6 +20,8 @@ class PortKiller
     private LibuiVBox $checkboxContainer;
     private LibuiVBox $containerParent;
     private string $lastQueriedPort = '';
+    private ?LibuiProcess $pendingProcess = null;
+    private int $queryGeneration = 0;
 
     // 简单的日志函数
     private function log($message) {
@@ -131,13 +134,15 @@ class PortKiller
                     } else {
                         unset($this->checkboxes[$pid]);
                     }
-                    
-                    // 更新全选按钮文本
-                    $this->updateSelectAllButtonText();
                 }
             }
         });
 
+        // 全选/批量勾选时会连续触发，按钮文本每轮主循环只更新一次
+        $this->table->onCoalesced('table.checkbox_changed', function () {
+            $this->updateSelectAllButtonText();
+        });
+
         // 将表格添加到容器
         $this->checkboxContainer->append($this->table, true);
 
@@ -185,16 +190,36 @@ class PortKiller
             return;
         }
 
+        // 支持多个端口和端口区间，例如 "80,443,8000-8100"
+        if (empty(ProcSocketScanner::parsePortSpec($port))) {
+            $this->log("Invalid port spec: " . $port);
+            return;
+        }
+
         // 保存端口号，因为在重建界面时可能会丢失
         $this->lastQueriedPort = $port;
         $this->log("Saved lastQueriedPort: " . $this->lastQueriedPort);
 
-        // 查询端口占用进程
-        $this->processes = $this->getPortProcessesInfo($port);
-        $this->log("Found " . count($this->processes) . " processes");
+        // 新的查询开始时取消还在运行的旧查询
+        if ($this->pendingProcess !== null) {
+            $this->pendingProcess->cancel();
+            $this->pendingProcess = null;
+        }
+        $generation = ++$this->queryGeneration;
+
+        // 查询端口占用进程，外部命令异步执行，完成后再刷新表格
+        $this->getPortProcessesInfo($port, function (array $processes) use ($generation) {
+            if ($generation !== $this->queryGeneration) {
+                // 已被更新的查询取代
+                return;
+            }
+            $this->pendingProcess = null;
+            $this->processes = $processes;
+            $this->log("Found " . count($this->processes) . " processes");
 
-        // 显示进程列表（这会自动清除旧的内容）
-        $this->displayProcessList();
+            // 显示进程列表（这会自动清除旧的内容）
+            $this->displayProcessList();
+        });
     }
 
     /**
@@ -363,10 +388,7 @@ class PortKiller
      */
     private function updateSelectAllButtonText() {
         if ($this->selectAllBtn !== null) {
-            $buttonText = $this->getSelectAllButtonText();
-            // 由于SDK中可能没有setText方法，我们需要重新创建按钮
-            // 但在这里我们只是更新按钮的文本
-            // 注意：在libui中，可能需要重新创建按钮才能更新文本
+            $this->selectAllBtn->setText($this->getSelectAllButtonText());
         }
     }
 
@@ -469,175 +491,235 @@ class PortKiller
         }
 
         $this->log("Killing selected processes: " . json_encode($selectedPids));
-        $results = [];
+        $remaining = count($selectedPids);
         foreach ($selectedPids as $pid) {
-            $results[] = $this->killProcessById($pid);
+            $this->killProcessById($pid, function (string $result) use (&$remaining) {
+                $this->log($result);
+                // 所有 kill 命令结束后重新查询
+                if (--$remaining === 0) {
+                    $this->log("About to call queryPort from killSelectedProcesses");
+                    $this->queryPort();
+                }
+            });
         }
 
         // 清空选中状态
         $this->checkboxes = [];
-
-        // 延迟调用queryPort方法，避免GUI事件冲突
-        // 使用setTimeout或类似机制延迟执行
-        $this->log("Scheduling queryPort call after delay");
-        // 这里我们简单地记录需要延迟调用，实际的延迟机制需要在LibuiApplication中实现
-        // 暂时先直接调用，但添加更多的日志来追踪问题
-        $this->log("About to call queryPort from killSelectedProcesses");
-        $this->queryPort();
-        $this->log("Finished calling queryPort from killSelectedProcesses");
     }
 
     /**
      * 获取端口进程详细信息
+     *
+     * @param callable $callback function(array $processes)，外部命令结束后在主线程回调
      */
-    private function getPortProcessesInfo($port)
+    private function getPortProcessesInfo($port, callable $callback)
     {
         $this->log("getPortProcessesInfo called with port: " . $port);
         $os = \App\App::getOperatingSystem();
         $this->log("Operating system detected: " . $os);
-        $command = '';
-        $output = [];
-        $processes = [];
+        $ranges = ProcSocketScanner::parsePortSpec((string)$port);
 
         if ($os === 'WIN') {
             // Windows系统
-            $command = "netstat -ano | findstr :{$port}";
-            $this->log("Executing command: " . $command);
-            exec($command, $output);
+            $this->queryPortWindows($ranges, $callback);
+        } elseif ($os === 'DAR' || $os === 'LIN') {
+            // Linux 优先直接读取 /proc，一次遍历完成所有端口的查询
+            $scanner = new ProcSocketScanner();
+            if ($os === 'LIN' && $scanner->isSupported()) {
+                $this->log("Scanning /proc for ports: " . $port);
+                $callback($scanner->scan($ranges));
+            } else {
+                $this->queryPortUnix($ranges, $callback);
+            }
+        } else {
+            $callback([]);
+        }
+    }
+
+    /**
+     * 使用 netstat 查询端口（Windows）
+     *
+     * netstat、tasklist、PowerShell 各执行一次，而不是每个PID执行一次
+     */
+    private function queryPortWindows(array $ranges, callable $callback)
+    {
+        $command = "netstat -ano";
+        $this->log("Executing command: " . $command);
+        $this->runQueryCommand($command, function (array $output) use ($ranges, $callback) {
             $this->log("Command returned " . count($output) . " lines");
 
+            $rows = [];
             foreach ($output as $line) {
                 // 格式: 协议 本地地址:端口 远程地址:端口 状态 PID
-                $line = trim($line);
-                $parts = preg_split('/\s+/', $line);
+                $parts = preg_split('/\s+/', trim($line));
+                if (count($parts) >= 5 && ($this->addressMatches($parts[1], $ranges) || $this->addressMatches($parts[2], $ranges))) {
+                    $this->log("Found process with PID: " . $parts[4]);
+                    $rows[] = $parts;
+                }
+            }
 
-                if (count($parts) >= 5) {
-                    $pid = $parts[4];
-                    $this->log("Found process with PID: " . $pid);
-                    // 获取该进程的更多信息
-                    $processInfo = [];
-                    $processInfoCmd = "tasklist /FI \"PID eq {$pid}\" /FO CSV /NH";
-                    $processInfoOutput = [];
-                    exec($processInfoCmd, $processInfoOutput);
-
-                    $user = $parts[0]; // 默认使用协议作为User
-                    $command = $parts[1]; // 默认使用本地地址作为Command
-
-                    // 如果找到进程信息，更新User和Command
-                    if (!empty($processInfoOutput)) {
-                        $processLine = str_replace('"', '', $processInfoOutput[0]);
-                        $processParts = explode(',', $processLine);
-                        if (count($processParts) >= 3) {
-                            $command = $processParts[0]; // 进程名称
-                            $user = $processParts[2];    // 用户名
-
-                            // 使用PowerShell获取完整命令行
-                            $cmdOutput = [];
-                            $psCommand = "powershell.exe -Command \"Get-WmiObject Win32_Process -Filter \"ProcessId = {$pid}\" | Select-Object CommandLine | Format-List\"";
-                            exec($psCommand, $cmdOutput);
-
-                            // 解析PowerShell输出获取完整命令行
-                            if (!empty($cmdOutput)) {
-                                foreach ($cmdOutput as $outputLine) {
-                                    if (strpos($outputLine, 'CommandLine') !== false) {
-                                        // 提取冒号后的内容作为命令行
-                                        $cmdParts = explode(':', $outputLine, 2);
-                                        if (isset($cmdParts[1])) {
-                                            $command = trim($cmdParts[1]);
-                                            // 移除可能的空格和引号
-                                            $command = trim($command, " \t\n\r\0\x0B\"");
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
+            $pids = array_values(array_unique(array_column($rows, 4)));
+            if (empty($pids)) {
+                $callback([]);
+                return;
+            }
+
+            // 获取这些进程的名称和用户
+            $this->runQueryCommand("tasklist /FO CSV /NH", function (array $taskOutput) use ($rows, $pids, $callback) {
+                $tasks = [];
+                $wanted = array_flip($pids);
+                foreach ($taskOutput as $taskLine) {
+                    $taskParts = str_getcsv($taskLine);
+                    // 格式: 映像名称,PID,会话名,会话#,内存使用
+                    if (count($taskParts) >= 3 && isset($wanted[$taskParts[1]])) {
+                        $tasks[$taskParts[1]] = ['name' => $taskParts[0], 'user' => $taskParts[2]];
+                    }
+                }
+
+                // 使用PowerShell一次获取所有进程的完整命令行
+                $filter = implode(' OR ', array_map(fn($pid) => "ProcessId = {$pid}", $pids));
+                $psCommand = "powershell.exe -Command \"Get-WmiObject Win32_Process -Filter '{$filter}' | Select-Object ProcessId,CommandLine | Format-List\"";
+                $this->runQueryCommand($psCommand, function (array $cmdOutput) use ($rows, $tasks, $callback) {
+                    // 解析PowerShell输出获取完整命令行
+                    $commandLines = [];
+                    $currentPid = null;
+                    foreach ($cmdOutput as $outputLine) {
+                        $cmdParts = explode(':', $outputLine, 2);
+                        if (!isset($cmdParts[1])) {
+                            continue;
+                        }
+                        $key = trim($cmdParts[0]);
+                        if ($key === 'ProcessId') {
+                            $currentPid = trim($cmdParts[1]);
+                        } elseif ($key === 'CommandLine' && $currentPid !== null) {
+                            // 移除可能的空格和引号
+                            $commandLines[$currentPid] = trim($cmdParts[1], " \t\n\r\0\x0B\"");
                         }
                     }
 
-                    $processes[] = [
-                        'protocol' => $parts[0],
-                        'local_address' => $parts[1],
-                        'remote_address' => $parts[2],
-                        'state' => $parts[3],
-                        'pid' => $pid,
-                        'session' => $user,   // 用于User列
-                        'name' => $command    // 用于Command列
-                    ];
-                }
-            }
-        } elseif ($os === 'DAR' || $os === 'LIN') {
-            // macOS或Linux系统
-            $command = "lsof -i :{$port} -n -P 2>/dev/null";
-            $this->log("Executing command: " . $command);
-            exec($command, $output);
+                    $processes = [];
+                    foreach ($rows as $parts) {
+                        $pid = $parts[4];
+                        // 默认使用协议作为User，本地地址作为Command
+                        $user = $tasks[$pid]['user'] ?? $parts[0];
+                        $command = ($commandLines[$pid] ?? '') !== '' ? $commandLines[$pid] : ($tasks[$pid]['name'] ?? $parts[1]);
+                        $processes[] = [
+                            'protocol' => $parts[0],
+                            'local_address' => $parts[1],
+                            'remote_address' => $parts[2],
+                            'state' => $parts[3],
+                            'pid' => $pid,
+                            'session' => $user,   // 用于User列
+                            'name' => $command    // 用于Command列
+                        ];
+                    }
+                    $callback($processes);
+                });
+            });
+        });
+    }
+
+    /**
+     * 使用 lsof 查询端口（macOS，或 /proc 不可用的Linux）
+     */
+    private function queryPortUnix(array $ranges, callable $callback)
+    {
+        // 多个 -i 条件之间是"或"关系，一次 lsof 查完所有端口
+        $command = "lsof -n -P";
+        foreach ($ranges as [$low, $high]) {
+            $command .= $low === $high ? " -i :{$low}" : " -i :{$low}-{$high}";
+        }
+        $command .= " 2>/dev/null";
+        $this->log("Executing command: " . $command);
+        $this->runQueryCommand($command, function (array $output) use ($callback) {
             $this->log("Command returned " . count($output) . " lines");
 
-            $this->log("Processing " . count($output) . " lines of output");
-            // 处理每一行输出，跳过标题行
-            for ($i = 0; $i < count($output); $i++) {
-                $line = trim($output[$i]);
-                $this->log("Processing line: " . $line);
-                // 跳过标题行和其他无关行
-                if (empty($line)) {
-                    $this->log("Skipping empty line");
-                    continue;
-                }
-                
-                // 对于第一行，检查是否是标题行
-                if ($i == 0 && strpos($line, 'COMMAND') !== false) {
-                    $this->log("Skipping header line");
+            $rows = [];
+            foreach ($output as $i => $line) {
+                $line = trim($line);
+                // 跳过空行和标题行
+                if (empty($line) || ($i == 0 && strpos($line, 'COMMAND') !== false)) {
                     continue;
                 }
 
-                $parts = preg_split('/\s+/', $line);
-                $this->log("Line split into " . count($parts) . " parts");
-
                 // lsof 输出格式: COMMAND PID USER FD TYPE DEVICE SIZE/OFF NODE NAME
-                // 我们需要至少5个字段（COMMAND, PID, USER, FD, TYPE）
+                $parts = preg_split('/\s+/', $line);
                 if (count($parts) >= 5) {
-                    $processName = $parts[0]; // 进程名称
-                    $pid = $parts[1];    // 进程 ID
-                    $user = $parts[2];    // 用户名
-                    $protocol = isset($parts[4]) ? $parts[4] : ''; // 协议类型
-                    $localAddr = isset($parts[8]) ? $parts[8] : (isset($parts[4]) ? $parts[4] : ''); // 本地地址和端口
-
-                    $this->log("Found process: name={$processName}, pid={$pid}, user={$user}");
-
-                    // 获取进程的完整命令
-                    $cmdOutput = [];
-                    $cmdCmd = "ps -p {$pid} -o command= 2>/dev/null";
-                    $this->log("Executing command: " . $cmdCmd);
-                    exec($cmdCmd, $cmdOutput);
-                    $commandLine = $processName; // 默认使用进程名称
-                    if (!empty($cmdOutput)) {
-                        $commandLine = trim($cmdOutput[0]); // 更新为完整命令行
-                        $this->log("Command line: " . $commandLine);
+                    $rows[] = $parts;
+                }
+            }
+
+            $pids = array_unique(array_column($rows, 1));
+            if (empty($pids)) {
+                $callback([]);
+                return;
+            }
+
+            // 一次 ps 获取所有进程的完整命令行，而不是每个PID执行一次
+            $psCommand = "ps -o pid=,command= -p " . implode(',', $pids) . " 2>/dev/null";
+            $this->runQueryCommand($psCommand, function (array $psOutput) use ($rows, $callback) {
+                $commandLines = [];
+                foreach ($psOutput as $psLine) {
+                    $psParts = preg_split('/\s+/', trim($psLine), 2);
+                    if (count($psParts) === 2) {
+                        $commandLines[$psParts[0]] = $psParts[1];
                     }
+                }
 
+                $processes = [];
+                foreach ($rows as $parts) {
+                    $pid = $parts[1];
                     $processes[] = [
-                        'protocol' => $protocol,
-                        'local_address' => $localAddr,
+                        'protocol' => $parts[4],
+                        'local_address' => $parts[8] ?? $parts[4],
                         'remote_address' => '',
                         'state' => 'LISTEN',
                         'pid' => $pid,
-                        'session' => $user,   // 用于User列
-                        'name' => $commandLine    // 用于Command列
+                        'session' => $parts[2],   // 用于User列
+                        'name' => $commandLines[$pid] ?? $parts[0]    // 用于Command列
                     ];
-                    $this->log("Added process to list");
-                } else {
-                    $this->log("Skipping line with insufficient parts: " . count($parts));
                 }
+                $callback($processes);
+            });
+        });
+    }
+
+    /**
+     * 异步执行查询命令，被取消的命令不再回调
+     */
+    private function runQueryCommand(string $command, callable $callback)
+    {
+        $this->pendingProcess = LibuiProcess::run($command, function (array $output, int $exitCode, array $errors, LibuiProcess $process) use ($callback) {
+            if (!$process->isCancelled()) {
+                $callback($output);
             }
-        }
+        });
+    }
 
-        $this->log("Returning " . count($processes) . " processes");
-        return $processes;
+    /**
+     * 判断 地址:端口 中的端口是否落在查询区间内
+     */
+    private function addressMatches(string $address, array $ranges): bool
+    {
+        $pos = strrpos($address, ':');
+        if ($pos === false) {
+            return false;
+        }
+        $port = (int)substr($address, $pos + 1);
+        foreach ($ranges as [$low, $high]) {
+            if ($port >= $low && $port <= $high) {
+                return true;
+            }
+        }
+        return false;
     }
 
     /**
      * 杀进程
+     *
+     * @param callable $callback function(string $result)
      */
-    private function killProcessById($pid)
+    private function killProcessById($pid, callable $callback)
     {
         $os = \App\App::getOperatingSystem();
         $command = '';
@@ -649,18 +731,16 @@ class PortKiller
             // macOS或Linux系统
             $command = "kill -9 {$pid}";
         } else {
-            return "不支持的操作系统";
+            $callback("不支持的操作系统");
+            return;
         }
 
-        $output = [];
-        $returnCode = 0;
-        exec($command, $output, $returnCode);
-
-        if ($returnCode === 0) {
-            return "成功终止进程 {$pid}";
-        } else {
-            return "终止进程 {$pid} 失败: " . implode("\n", $output);
-        }
+        LibuiProcess::run($command, function (array $output, int $returnCode, array $errors) use ($pid, $callback) {
+            if ($returnCode === 0) {
+                $callback("成功终止进程 {$pid}");
+            } else {
+                $callback("终止进程 {$pid} 失败: " . implode("\n", array_merge($output, $errors)));
+            }
+        });
     }
 }
-
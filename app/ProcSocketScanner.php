@@ -0,0 +1,289 @@
+<?php
+
+namespace App;
+
+/**
+ * 基于 /proc 的端口占用扫描器（仅Linux）
+ *
+ * 一次读取 /proc/net/{tcp,tcp6,udp,udp6} 得到目标端口的 socket inode，
+ * 再对 /proc/PID/fd 做一次遍历把 inode 映射到进程，
+ * 进程信息直接读取 cmdline/status，不再 fork lsof 和 ps。
+ */
+class ProcSocketScanner
+{
+    private string $procRoot;
+
+    /**
+     * uid => 用户名 缓存
+     */
+    private array $userCache = [];
+
+    /**
+     * TCP 状态码（/proc/net/tcp 中的 st 字段）
+     */
+    private const TCP_STATES = [
+        '01' => 'ESTABLISHED',
+        '02' => 'SYN_SENT',
+        '03' => 'SYN_RECV',
+        '04' => 'FIN_WAIT1',
+        '05' => 'FIN_WAIT2',
+        '06' => 'TIME_WAIT',
+        '07' => 'CLOSE',
+        '08' => 'CLOSE_WAIT',
+        '09' => 'LAST_ACK',
+        '0A' => 'LISTEN',
+        '0B' => 'CLOSING',
+    ];
+
+    /**
+     * 需要扫描的 /proc/net 表及其协议名
+     */
+    private const TABLES = [
+        'tcp' => 'TCP',
+        'tcp6' => 'TCP6',
+        'udp' => 'UDP',
+        'udp6' => 'UDP6',
+    ];
+
+    public function __construct(string $procRoot = '/proc')
+    {
+        $this->procRoot = rtrim($procRoot, '/');
+    }
+
+    /**
+     * 当前系统是否可以使用 /proc 扫描
+     */
+    public function isSupported(): bool
+    {
+        return is_readable($this->procRoot . '/net/tcp');
+    }
+
+    /**
+     * 解析端口表达式，例如 "80"、"80,443"、"8000-8100, 9000"
+     *
+     * @return array<int, array{0: int, 1: int}> 端口区间列表，格式错误时返回空数组
+     */
+    public static function parsePortSpec(string $spec): array
+    {
+        $ranges = [];
+        foreach (preg_split('/[\s,]+/', trim($spec), -1, PREG_SPLIT_NO_EMPTY) as $part) {
+            if (!preg_match('/^(\d{1,5})(?:-(\d{1,5}))?$/', $part, $m)) {
+                return [];
+            }
+            $low = (int)$m[1];
+            $high = isset($m[2]) ? (int)$m[2] : $low;
+            if ($low < 1 || $high > 65535 || $low > $high) {
+                return [];
+            }
+            $ranges[] = [$low, $high];
+        }
+        return $ranges;
+    }
+
+    /**
+     * 扫描占用指定端口（本地或远端）的进程
+     *
+     * @param array $ranges parsePortSpec() 返回的端口区间
+     * @return array 与 PortKiller 表格一致的进程行（每个 socket 一行）
+     */
+    public function scan(array $ranges): array
+    {
+        if (empty($ranges)) {
+            return [];
+        }
+
+        // 端口位图，查找为 O(1)
+        $portSet = [];
+        foreach ($ranges as [$low, $high]) {
+            for ($port = $low; $port <= $high; $port++) {
+                $portSet[$port] = true;
+            }
+        }
+
+        $sockets = $this->readSocketTables($portSet);
+        if (empty($sockets)) {
+            return [];
+        }
+
+        $owners = $this->mapInodesToPids($sockets);
+
+        $processes = [];
+        $infoCache = [];
+        foreach ($owners as $inode => $pids) {
+            $socket = $sockets[$inode];
+            foreach ($pids as $pid) {
+                if (!isset($infoCache[$pid])) {
+                    $infoCache[$pid] = $this->readProcessInfo($pid);
+                }
+                $processes[] = [
+                    'protocol' => $socket['protocol'],
+                    'local_address' => $socket['local_address'],
+                    'remote_address' => $socket['remote_address'],
+                    'state' => $socket['state'],
+                    'pid' => (string)$pid,
+                    'session' => $infoCache[$pid]['user'],
+                    'name' => $infoCache[$pid]['command'],
+                    'inode' => $inode,
+                    'local_port' => $socket['local_port'],
+                ];
+            }
+        }
+
+        usort($processes, function ($a, $b) {
+            return [(int)$a['pid'], $a['local_port']] <=> [(int)$b['pid'], $b['local_port']];
+        });
+
+        return $processes;
+    }
+
+    /**
+     * 读取全部 socket 表，返回命中端口的 inode => socket 信息
+     */
+    private function readSocketTables(array $portSet): array
+    {
+        $sockets = [];
+        foreach (self::TABLES as $table => $protocol) {
+            $content = @file_get_contents($this->procRoot . '/net/' . $table);
+            if ($content === false) {
+                continue;
+            }
+            $isTcp = $protocol[0] === 'T';
+            $lines = explode("\n", $content);
+            // 第一行是表头
+            for ($i = 1, $n = count($lines); $i < $n; $i++) {
+                $parts = preg_split('/\s+/', trim($lines[$i]));
+                if (count($parts) < 10) {
+                    continue;
+                }
+                [$localHex, $localPortHex] = explode(':', $parts[1]);
+                [$remoteHex, $remotePortHex] = explode(':', $parts[2]);
+                $localPort = hexdec($localPortHex);
+                $remotePort = hexdec($remotePortHex);
+                if (!isset($portSet[$localPort]) && !isset($portSet[$remotePort])) {
+                    continue;
+                }
+                // inode 为 0 的是已无属主的连接（如 TIME_WAIT）
+                $inode = $parts[9];
+                if ($inode === '0') {
+                    continue;
+                }
+                $sockets[$inode] = [
+                    'protocol' => $protocol,
+                    'local_address' => self::formatEndpoint($localHex, $localPort),
+                    'remote_address' => $remotePort === 0 ? '' : self::formatEndpoint($remoteHex, $remotePort),
+                    'state' => $isTcp ? (self::TCP_STATES[$parts[3]] ?? $parts[3]) : ($parts[3] === '01' ? 'ESTABLISHED' : ''),
+                    'local_port' => $localPort,
+                ];
+            }
+        }
+        return $sockets;
+    }
+
+    /**
+     * 遍历一次 /proc/PID/fd，把目标 inode 映射到持有它的进程
+     *
+     * @return array inode => PID 列表
+     */
+    private function mapInodesToPids(array $sockets): array
+    {
+        $owners = [];
+        $entries = @scandir($this->procRoot);
+        if ($entries === false) {
+            return $owners;
+        }
+        foreach ($entries as $pid) {
+            if (!ctype_digit($pid)) {
+                continue;
+            }
+            $fdDir = $this->procRoot . '/' . $pid . '/fd';
+            // 无权限访问的进程直接跳过
+            $fds = @scandir($fdDir);
+            if ($fds === false) {
+                continue;
+            }
+            foreach ($fds as $fd) {
+                if ($fd === '.' || $fd === '..') {
+                    continue;
+                }
+                $target = @readlink($fdDir . '/' . $fd);
+                // 目标格式: socket:[12345]
+                if ($target === false || strncmp($target, 'socket:[', 8) !== 0) {
+                    continue;
+                }
+                $inode = substr($target, 8, -1);
+                if (isset($sockets[$inode])) {
+                    // 同一进程的多个fd可能指向同一socket，只记录一次
+                    $owners[$inode][(int)$pid] = (int)$pid;
+                }
+            }
+        }
+        return $owners;
+    }
+
+    /**
+     * 直接读取 /proc/PID/cmdline 和 status 获取命令行与用户
+     */
+    private function readProcessInfo(int $pid): array
+    {
+        $base = $this->procRoot . '/' . $pid;
+        $name = '';
+        $uid = null;
+
+        $status = @file_get_contents($base . '/status');
+        if ($status !== false) {
+            if (preg_match('/^Name:\s*(.*)$/m', $status, $m)) {
+                $name = trim($m[1]);
+            }
+            if (preg_match('/^Uid:\s*(\d+)/m', $status, $m)) {
+                $uid = (int)$m[1];
+            }
+        }
+
+        // cmdline 以 \0 分隔参数，内核线程为空
+        $command = @file_get_contents($base . '/cmdline');
+        $command = $command === false ? '' : trim(str_replace("\0", ' ', $command));
+        if ($command === '') {
+            $command = $name;
+        }
+
+        return [
+            'user' => $uid === null ? '' : $this->resolveUser($uid),
+            'command' => $command,
+        ];
+    }
+
+    /**
+     * uid 转用户名，posix 扩展不可用时返回 uid
+     */
+    private function resolveUser(int $uid): string
+    {
+        if (!isset($this->userCache[$uid])) {
+            $user = function_exists('posix_getpwuid') ? posix_getpwuid($uid) : false;
+            $this->userCache[$uid] = $user ? $user['name'] : (string)$uid;
+        }
+        return $this->userCache[$uid];
+    }
+
+    /**
+     * 格式化为 地址:端口，IPv6 地址加方括号
+     */
+    private static function formatEndpoint(string $hex, int $port): string
+    {
+        $address = self::decodeAddress($hex);
+        return (strlen($hex) > 8 ? '[' . $address . ']' : $address) . ':' . $port;
+    }
+
+    /**
+     * 解码 /proc/net 中的十六进制地址（按32位字小端存储）
+     */
+    private static function decodeAddress(string $hex): string
+    {
+        $words = str_split($hex, 8);
+        $binary = '';
+        foreach ($words as $word) {
+            $binary .= pack('V', hexdec($word));
+        }
+        $address = @inet_ntop($binary);
+        return $address === false ? $hex : $address;
+    }
+}
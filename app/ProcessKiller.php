@@ -5,6 +5,7 @@ namespace App;
 use Kingbes\Libui\SDK\LibuiVBox;
 use Kingbes\Libui\SDK\LibuiHBox;
 use Kingbes\Libui\SDK\LibuiButton;
+use Kingbes\Libui\SDK\LibuiCheckbox;
 use Kingbes\Libui\SDK\LibuiEntry;
 use Kingbes\Libui\SDK\LibuiLabel;
 use Kingbes\Libui\SDK\LibuiTable;
@@ -20,6 +21,12 @@ class ProcessKiller
     private LibuiVBox $containerParent;
     private ?LibuiButton $selectAllBtn = null;
     private ?LibuiTable $table = null;
+    private ?ProcessMonitor $monitor = null;
+    private bool $autoRefresh = false;
+    private bool $timerRunning = false;
+
+    // 自动刷新间隔（毫秒）
+    private const REFRESH_INTERVAL = 1000;
     
     // 简单的日志函数
     private function log($message) {
@@ -52,6 +59,20 @@ class ProcessKiller
             $this->queryProcess();
         });
         $inputBox->append($queryBtn, false);
+
+        // 自动刷新开关
+        $autoRefreshCheckbox = new LibuiCheckbox("自动刷新");
+        $autoRefreshCheckbox->onToggled(function($checkbox, $checked) {
+            $this->log("Auto refresh toggled: " . ($checked ? "on" : "off"));
+            $this->setAutoRefresh($checked);
+        });
+        $inputBox->append($autoRefreshCheckbox, false);
+
+        // Linux 下直接读取 /proc，支持增量刷新
+        $monitor = new ProcessMonitor();
+        if ($monitor->isSupported()) {
+            $this->monitor = $monitor;
+        }
         
         // 结果标签
         $resultLabel = new LibuiLabel("进程列表（勾选需要终止的进程）:");
@@ -94,7 +115,9 @@ class ProcessKiller
         $this->table->addCheckboxColumn("", 0, -1)
               ->addTextColumn("PID", 1)
               ->addTextColumn("User", 2)
-              ->addTextColumn("Command", 3);
+              ->addTextColumn("CPU%", 3)
+              ->addTextColumn("RSS", 4)
+              ->addTextColumn("Command", 5);
 
         // 设置选择改变事件
         $this->table->onSelectionChanged(function($selectedRow, $selectedRows, $tableComponent) {
@@ -129,13 +152,15 @@ class ProcessKiller
                     } else {
                         unset($this->checkboxes[$pid]);
                     }
-                    
-                    // 更新全选按钮文本
-                    $this->updateSelectAllButtonText();
                 }
             }
         });
 
+        // 全选/批量勾选时会连续触发，按钮文本每轮主循环只更新一次
+        $this->table->onCoalesced('table.checkbox_changed', function () {
+            $this->updateSelectAllButtonText();
+        });
+
         // 将表格添加到容器
         $this->checkboxContainer->append($this->table, true);
 
@@ -179,6 +204,12 @@ class ProcessKiller
             return;
         }
         
+        // Linux 下使用 /proc 快照增量更新表格
+        if ($this->monitor !== null) {
+            $this->refreshFromMonitor($process);
+            return;
+        }
+
         // 查询进程
         $this->processes = $this->getProcessesInfo($process);
         $this->log("Found " . count($this->processes) . " processes");
@@ -186,6 +217,92 @@ class ProcessKiller
         // 显示进程列表
         $this->displayProcessList();
     }
+
+    /**
+     * 开启/关闭自动刷新
+     */
+    private function setAutoRefresh(bool $enabled)
+    {
+        $this->autoRefresh = $enabled;
+        if (!$enabled || $this->timerRunning) {
+            // 关闭时由定时器在下一次触发时自行停止
+            return;
+        }
+
+        $this->timerRunning = true;
+        $this->refreshProcesses();
+        LibuiApplication::getInstance()->timer(self::REFRESH_INTERVAL, function() {
+            if (!$this->autoRefresh) {
+                $this->timerRunning = false;
+                return false;
+            }
+            $this->refreshProcesses();
+            return true;
+        });
+    }
+
+    /**
+     * 自动刷新：输入框为空时显示全部进程
+     */
+    private function refreshProcesses()
+    {
+        $filter = $this->processEntry->getText();
+        if ($this->monitor !== null) {
+            $this->refreshFromMonitor($filter);
+        } elseif (!empty($filter)) {
+            $this->processes = $this->getProcessesInfo($filter);
+            $this->displayProcessList();
+        }
+    }
+
+    /**
+     * 获取 /proc 快照，与上一次比较后只通知变化的行
+     */
+    private function refreshFromMonitor(string $filter)
+    {
+        $start = hrtime(true);
+        $processes = $this->monitor->snapshot($filter);
+        $ops = ProcessMonitor::diff($this->processes, $processes);
+
+        foreach ($ops as $op) {
+            switch ($op[0]) {
+                case 'delete':
+                    $this->table->removeRow($op[1]);
+                    break;
+                case 'insert':
+                    $this->table->insertRow($op[1], $this->buildRow($op[2]));
+                    break;
+                case 'update':
+                    $this->table->updateRow($op[1], $this->buildRow($op[2]));
+                    break;
+            }
+        }
+        $this->processes = $processes;
+
+        // 已退出进程的勾选状态一并清除
+        $this->checkboxes = array_intersect_key($this->checkboxes, array_flip(array_column($processes, 'pid')));
+
+        $elapsed = (hrtime(true) - $start) / 1e6;
+        if ($elapsed > 16) {
+            $this->log(sprintf("Refresh took %.1f ms for %d processes, %d row changes", $elapsed, count($processes), count($ops)));
+        }
+    }
+
+    /**
+     * 构造表格行
+     */
+    private function buildRow(array $process)
+    {
+        $pid = $process['pid'] ?? '';
+        return [
+            isset($this->checkboxes[$pid]) ? 1 : 0, // 复选框状态
+            $pid, // PID
+            $process['session'] ?? '', // 用户
+            $process['cpu'] ?? '', // CPU%
+            $process['rss'] ?? '', // 常驻内存
+            isset($process['command']) ? $process['command'] : $process['name'] // 命令
+        ];
+    }
     
     /**
      * 清除复选框
@@ -214,14 +331,7 @@ class ProcessKiller
             // 设置数据
             $data = [];
             foreach ($this->processes as $process) {
-                $pid = $process['pid'] ?? '';
-                $isChecked = isset($this->checkboxes[$pid]) ? 1 : 0;
-                $data[] = [
-                    $isChecked, // 复选框状态
-                    $pid, // PID
-                    $process['session'] ?? '', // 用户
-                    isset($process['command']) ? $process['command'] : $process['name'] // 命令
-                ];
+                $data[] = $this->buildRow($process);
             }
             // 确保即使没有数据也会设置一个空数组
             if (empty($data)) {
@@ -272,10 +382,7 @@ class ProcessKiller
      */
     private function updateSelectAllButtonText() {
         if ($this->selectAllBtn !== null) {
-            $buttonText = $this->getSelectAllButtonText();
-            // 由于SDK中可能没有setText方法，我们需要重新创建按钮
-            // 但在这里我们只是更新按钮的文本
-            // 注意：在libui中，可能需要重新创建按钮才能更新文本
+            $this->selectAllBtn->setText($this->getSelectAllButtonText());
         }
     }
     
@@ -339,14 +446,7 @@ class ProcessKiller
         if ($this->table !== null) {
             $data = [];
             foreach ($this->processes as $process) {
-                $pid = $process['pid'] ?? '';
-                $isChecked = isset($this->checkboxes[$pid]) ? 1 : 0;
-                $data[] = [
-                    $isChecked, // 复选框状态
-                    $pid, // PID
-                    $process['session'] ?? '', // 用户
-                    isset($process['command']) ? $process['command'] : $process['name'] // 命令
-                ];
+                $data[] = $this->buildRow($process);
             }
             $this->table->setData($data);
         }
@@ -459,6 +559,7 @@ class ProcessKiller
                         'pid' => $pid,
                         'session' => $sessionName,
                         'memory' => $memory,
+                        'rss' => $memory,
                         'command' => $commandLine
                     ];
                 }
@@ -530,6 +631,8 @@ class ProcessKiller
                             'pid' => $pid,
                             'session' => $user,
                             'memory' => $mem,
+                            'cpu' => $cpu,
+                            'rss' => ProcessMonitor::formatBytes((int)$parts[5] * 1024),
                             'command' => $commandLine
                         ];
                     }
@@ -0,0 +1,269 @@
+<?php
+
+namespace App;
+
+/**
+ * 基于 /proc 的进程快照（仅Linux）
+ *
+ * 每次刷新只 scandir 一次 /proc，每个进程只读取一次 stat；
+ * cmdline 和属主按 PID 缓存，只在新进程出现（或PID被复用，starttime 变化）时读取一次。
+ * CPU% 由两次快照之间 utime+stime 的差值计算。
+ */
+class ProcessMonitor
+{
+    private string $procRoot;
+    private int $clockTicks = 100;
+    private int $pageSize = 4096;
+
+    /**
+     * PID => ['command' => ..., 'user' => ...] 缓存
+     */
+    private array $pidCache = [];
+
+    /**
+     * 行键(pid:starttime) => 上次的 CPU 时钟数
+     */
+    private array $lastTicks = [];
+    private ?float $lastTime = null;
+
+    /**
+     * uid => 用户名 缓存
+     */
+    private array $userCache = [];
+
+    public function __construct(string $procRoot = '/proc')
+    {
+        $this->procRoot = rtrim($procRoot, '/');
+        if (function_exists('posix_sysconf') && defined('POSIX_SC_CLK_TCK')) {
+            $this->clockTicks = posix_sysconf(POSIX_SC_CLK_TCK) ?: $this->clockTicks;
+            $this->pageSize = posix_sysconf(POSIX_SC_PAGESIZE) ?: $this->pageSize;
+        }
+    }
+
+    /**
+     * 当前系统是否可以使用 /proc 快照
+     */
+    public function isSupported(): bool
+    {
+        return is_readable($this->procRoot . '/self/stat');
+    }
+
+    /**
+     * 获取一次进程快照
+     *
+     * @param string $filter 进程名/命令行子串或PID，空字符串表示全部进程
+     * @return array 按PID升序排列的进程行
+     */
+    public function snapshot(string $filter = ''): array
+    {
+        $now = microtime(true);
+        $elapsed = $this->lastTime === null ? 0.0 : $now - $this->lastTime;
+        $this->lastTime = $now;
+
+        $entries = @scandir($this->procRoot);
+        if ($entries === false) {
+            return [];
+        }
+
+        $filter = trim($filter);
+        $filterPid = ctype_digit($filter) ? $filter : null;
+
+        $alive = [];
+        $rows = [];
+        $ticks = [];
+        foreach ($entries as $pid) {
+            if (!ctype_digit($pid)) {
+                continue;
+            }
+            $alive[$pid] = true;
+
+            if ($filterPid !== null && $pid !== $filterPid) {
+                continue;
+            }
+
+            $stat = $this->readStat($pid);
+            if ($stat === null) {
+                continue;
+            }
+
+            // PID 被复用时 starttime 会变化，需要重新读取命令行；缓存的不匹配结果只对同一个进程有效
+            $info = $this->pidCache[$pid] ?? null;
+            if ($info === null || $info['start'] !== $stat['start']) {
+                $info = $this->pidCache[$pid] = $this->readIdentity($pid, $stat);
+            }
+            if (!$this->matches($info, $filter, $filterPid)) {
+                continue;
+            }
+
+            $key = $pid . ':' . $stat['start'];
+            $ticks[$key] = $stat['ticks'];
+            $cpu = 0.0;
+            if ($elapsed > 0 && isset($this->lastTicks[$key])) {
+                $cpu = ($stat['ticks'] - $this->lastTicks[$key]) / ($elapsed * $this->clockTicks) * 100;
+            }
+
+            $rows[] = [
+                'key' => $key,
+                'pid' => $pid,
+                'name' => $stat['comm'],
+                'session' => $info['user'],
+                'cpu' => sprintf('%.1f', max(0.0, $cpu)),
+                'rss' => self::formatBytes($stat['rss'] * $this->pageSize),
+                'command' => $info['command'],
+            ];
+        }
+
+        // 清理已退出进程的缓存
+        $this->pidCache = array_intersect_key($this->pidCache, $alive);
+        $this->lastTicks = $ticks;
+
+        // scandir 按字符串排序，这里改为按数值排序，保证与 diff() 的比较一致
+        usort($rows, function ($a, $b) {
+            return (int)$a['pid'] <=> (int)$b['pid'];
+        });
+
+        return $rows;
+    }
+
+    /**
+     * 比较两次快照，生成最少的行操作
+     *
+     * 两个列表都必须按PID升序排列。返回的操作按顺序依次应用到表格即可：
+     * ['delete', 行号]、['insert', 行号, 行]、['update', 行号, 行]
+     */
+    public static function diff(array $old, array $new, callable $equals = null): array
+    {
+        $equals = $equals ?? function ($a, $b) {
+            return $a == $b;
+        };
+
+        $ops = [];
+        $i = 0; // 当前表格中的行号
+        $o = 0;
+        $n = 0;
+        $oldCount = count($old);
+        $newCount = count($new);
+        while ($o < $oldCount || $n < $newCount) {
+            if ($n >= $newCount) {
+                $cmp = -1;
+            } elseif ($o >= $oldCount) {
+                $cmp = 1;
+            } else {
+                $cmp = self::compareKey($old[$o]['key'], $new[$n]['key']);
+            }
+
+            if ($cmp < 0) {
+                // 旧行已不存在
+                $ops[] = ['delete', $i];
+                $o++;
+            } elseif ($cmp > 0) {
+                // 新出现的行
+                $ops[] = ['insert', $i, $new[$n]];
+                $i++;
+                $n++;
+            } else {
+                if (!$equals($old[$o], $new[$n])) {
+                    $ops[] = ['update', $i, $new[$n]];
+                }
+                $i++;
+                $o++;
+                $n++;
+            }
+        }
+        return $ops;
+    }
+
+    /**
+     * 进程是否匹配过滤条件（PID 过滤在遍历时已处理）
+     */
+    private function matches(array $info, string $filter, ?string $filterPid): bool
+    {
+        return $filter === '' || $filterPid !== null || stripos($info['command'], $filter) !== false;
+    }
+
+    /**
+     * 按 PID、starttime 比较行键
+     */
+    private static function compareKey(string $a, string $b): int
+    {
+        [$pidA, $startA] = explode(':', $a);
+        [$pidB, $startB] = explode(':', $b);
+        return [(int)$pidA, (int)$startA] <=> [(int)$pidB, (int)$startB];
+    }
+
+    /**
+     * 解析 /proc/PID/stat
+     */
+    private function readStat(string $pid): ?array
+    {
+        $stat = @file_get_contents($this->procRoot . '/' . $pid . '/stat');
+        if ($stat === false) {
+            return null;
+        }
+        // comm 字段在括号中且可能包含空格，从最后一个右括号之后开始分割
+        $open = strpos($stat, '(');
+        $close = strrpos($stat, ')');
+        if ($open === false || $close === false) {
+            return null;
+        }
+        // 从 state(第3个字段) 开始
+        $fields = explode(' ', substr($stat, $close + 2));
+        if (count($fields) < 22) {
+            return null;
+        }
+        return [
+            'comm' => substr($stat, $open + 1, $close - $open - 1),
+            'ticks' => (int)$fields[11] + (int)$fields[12], // utime + stime
+            'start' => $fields[19],                          // starttime
+            'rss' => (int)$fields[21],                       // rss (页)
+        ];
+    }
+
+    /**
+     * 读取进程的命令行和属主，每个进程只读取一次
+     */
+    private function readIdentity(string $pid, array $stat): array
+    {
+        $command = @file_get_contents($this->procRoot . '/' . $pid . '/cmdline');
+        $command = $command === false ? '' : trim(str_replace("\0", ' ', $command));
+        if ($command === '') {
+            // 内核线程没有命令行
+            $command = '[' . $stat['comm'] . ']';
+        }
+
+        // /proc/PID 目录的属主就是进程的有效用户
+        $uid = @fileowner($this->procRoot . '/' . $pid);
+
+        return [
+            'start' => $stat['start'],
+            'command' => $command,
+            'user' => $uid === false ? '' : $this->resolveUser($uid),
+        ];
+    }
+
+    /**
+     * uid 转用户名，posix 扩展不可用时返回 uid
+     */
+    private function resolveUser(int $uid): string
+    {
+        if (!isset($this->userCache[$uid])) {
+            $user = function_exists('posix_getpwuid') ? posix_getpwuid($uid) : false;
+            $this->userCache[$uid] = $user ? $user['name'] : (string)$uid;
+        }
+        return $this->userCache[$uid];
+    }
+
+    /**
+     * 字节数格式化
+     */
+    public static function formatBytes(int $bytes): string
+    {
+        if ($bytes >= 1073741824) {
+            return sprintf('%.1f GB', $bytes / 1073741824);
+        }
+        if ($bytes >= 1048576) {
+            return sprintf('%.1f MB', $bytes / 1048576);
+        }
+        return sprintf('%d KB', intdiv($bytes, 1024));
+    }
+}
@@ -12,6 +12,9 @@ use Kingbes\Libui\SDK\LibuiMultilineEntry;
 use Kingbes\Libui\SDK\LibuiProgressBar;
 use Kingbes\Libui\SDK\LibuiCheckbox;
 use Kingbes\Libui\SDK\LibuiApplication;
+use Kingbes\Libui\SDK\LibuiCallback;
+use Kingbes\Libui\SDK\LibuiLogBuffer;
+use Kingbes\Libui\SDK\LibuiProcess;
 
 class SQLite2MySQLTab
 {
@@ -21,10 +24,18 @@ class SQLite2MySQLTab
     private LibuiEntry $batchSizeEntry;
     private LibuiEntry $excludeTablesEntry;
     private LibuiCheckbox $dropExistingCheckbox;
+    private LibuiEntry $workersEntry;
+    private LibuiEntry $dumpDirEntry;
+    private LibuiCheckbox $loadDataCheckbox;
     private LibuiMultilineEntry $outputArea;
     private LibuiProgressBar $progressBar;
     private LibuiButton $convertButton;
     private LibuiLabel $statusLabel;
+    private LibuiLogBuffer $output;
+    private ?LibuiProcess $process = null;
+    private array $progress = [];
+    private bool $progressScheduled = false;
+    private ?LibuiCallback $progressCallback = null; // 进度更新的 uiQueueMain 回调，每次重复使用
 
     public function __construct()
     {
@@ -36,21 +47,9 @@ class SQLite2MySQLTab
         $titleLabel = new LibuiLabel("SQLite 到 MySQL 转换器");
         $this->box->append($titleLabel, false);
 
-        // 水平布局：端口输入框和查询按钮
-        $inputBox = new LibuiHBox();
-        $inputBox->setPadded(true);
-        $this->box->append($inputBox, false);
-
-        // 添加检查文件按钮
-        $checkFileButton = new LibuiButton("检查/下载必要文件");
-        $checkFileButton->onClick(function () {
-            $this->checkAndDownloadPhar();
-        });
-        $inputBox->append($checkFileButton, false);
-
         // 添加状态标签
-        $this->statusLabel = new LibuiLabel("正在检查必要的文件...");
-        $inputBox->append($this->statusLabel, false);
+        $this->statusLabel = new LibuiLabel("使用内置转换引擎");
+        $this->box->append($this->statusLabel, false);
 
         // 添加说明标签
         $descLabel = new LibuiLabel("将 SQLite 数据库文件同步到 MySQL 远程数据库");
@@ -61,75 +60,6 @@ class SQLite2MySQLTab
 
         // 创建输出区域
         $this->addOutputControls($this->box);
-
-        // 检查并下载 sqlite2mysql.phar 文件
-        $this->checkAndDownloadPhar();
-    }
-
-    /**
-     * 检查并下载 sqlite2mysql.phar 文件
-     */
-    private function checkAndDownloadPhar()
-    {
-        $this->statusLabel->setText("正在检查必要的文件...");
-
-        $pharPath = __DIR__ . '/../scripts/sqlite2mysql.phar';
-        
-        // 检查文件是否存在
-        if (!file_exists($pharPath)) {
-            $this->statusLabel->setText("正在下载 sqlite2mysql.phar 文件...");
-            LibuiApplication::getInstance()->queueMain(function() use($pharPath) {
-                if ($this->downloadPharFile($pharPath)) {
-                    $this->statusLabel->setText("文件已下载完成");
-                } else {
-                    $this->statusLabel->setText("警告: 无法下载 sqlite2mysql.phar 文件");
-                }
-            });
-        } else {
-            LibuiApplication::getInstance()->queueMain(fn() => $this->statusLabel->setText("必要的文件已就绪"));
-        }
-    }
-
-    /**
-     * 下载 sqlite2mysql.phar 文件
-     */
-    private function downloadPharFile($pharPath)
-    {
-        $downloadUrl = 'https://xget.xi-xu.me/gh/yangweijie/SQLite2MySQL/releases/download/v1.0.0/sqlite2mysql.phar';
-        
-        // 使用 cURL 下载文件
-        $ch = curl_init();
-        curl_setopt($ch, CURLOPT_URL, $downloadUrl);
-        curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
-        curl_setopt($ch, CURLOPT_FOLLOWLOCATION, true);
-        curl_setopt($ch, CURLOPT_SSL_VERIFYPEER, false);
-        curl_setopt($ch, CURLOPT_TIMEOUT, 30); // 30秒超时
-        
-        $pharData = curl_exec($ch);
-        $httpCode = curl_getinfo($ch, CURLINFO_HTTP_CODE);
-        $error = curl_error($ch);
-        curl_close($ch);
-        
-        // 检查下载是否成功
-        if ($httpCode === 200 && $pharData !== false) {
-            // 确保 scripts 目录存在
-            $scriptsDir = dirname($pharPath);
-            if (!is_dir($scriptsDir)) {
-                mkdir($scriptsDir, 0755, true);
-            }
-            
-            // 保存文件
-            if (file_put_contents($pharPath, $pharData) !== false) {
-                // 设置文件权限
-                chmod($pharPath, 0755);
-                return true;
-            }
-        } else {
-            // 下载失败，记录错误但不中断程序执行
-            error_log("Failed to download sqlite2mysql.phar from $downloadUrl. HTTP code: $httpCode, Error: $error");
-        }
-        
-        return false;
     }
 
     private function addInputControls(LibuiVBox $container)
@@ -195,6 +125,29 @@ class SQLite2MySQLTab
         $this->dropExistingCheckbox->setChecked(false);
         $inputBox->append($this->dropExistingCheckbox, false);
 
+        // 并行进程数标签
+        $workersLabel = new LibuiLabel("并行进程数 (按表并行):");
+        $inputBox->append($workersLabel, false);
+
+        // 并行进程数输入框
+        $this->workersEntry = new LibuiEntry();
+        $this->workersEntry->setText("4");
+        $inputBox->append($this->workersEntry, false);
+
+        // 导出目录标签
+        $dumpLabel = new LibuiLabel("导出目录 (填写后导出为文件，不连接 MySQL):");
+        $inputBox->append($dumpLabel, false);
+
+        // 导出目录输入框
+        $this->dumpDirEntry = new LibuiEntry();
+        $this->dumpDirEntry->setText("");
+        $inputBox->append($this->dumpDirEntry, false);
+
+        // 导出格式复选框
+        $this->loadDataCheckbox = new LibuiCheckbox("导出为 LOAD DATA 格式 (TSV)");
+        $this->loadDataCheckbox->setChecked(false);
+        $inputBox->append($this->loadDataCheckbox, false);
+
         // 转换按钮
         $this->convertButton = new LibuiButton("开始转换");
         $this->convertButton->onClick(function () {
@@ -225,11 +178,19 @@ class SQLite2MySQLTab
         // 多行输出区域
         $this->outputArea = new LibuiMultilineEntry();
         $this->outputArea->setText("等待开始转换...\n");
+        $this->output = new LibuiLogBuffer($this->outputArea);
         $outputBox->append($this->outputArea, true);
     }
 
     private function startConversion()
     {
+        // 转换进行中时按钮用于取消
+        if ($this->process !== null && $this->process->isRunning()) {
+            $this->appendOutput("\n正在取消转换...\n");
+            $this->process->cancel();
+            return;
+        }
+
         try {
             // 获取输入参数
             $sqliteFile = $this->sqliteFileEntry->getText();
@@ -237,6 +198,8 @@ class SQLite2MySQLTab
             $batchSize = (int)$this->batchSizeEntry->getText();
             $excludeTables = $this->excludeTablesEntry->getText();
             $dropExisting = $this->dropExistingCheckbox->isChecked();
+            $workers = max(1, (int)$this->workersEntry->getText());
+            $dumpDir = trim($this->dumpDirEntry->getText());
 
             // 验证必需参数
             if (empty($sqliteFile)) {
@@ -244,8 +207,8 @@ class SQLite2MySQLTab
                 return;
             }
 
-            if (empty($mysqlDsn)) {
-                $this->appendOutput("错误: 请指定 MySQL 连接字符串\n");
+            if (empty($mysqlDsn) && $dumpDir === '') {
+                $this->appendOutput("错误: 请指定 MySQL 连接字符串或导出目录\n");
                 return;
             }
 
@@ -254,38 +217,36 @@ class SQLite2MySQLTab
                 return;
             }
 
-            // 检查 sqlite2mysql.phar 文件是否存在
-            $pharPath = __DIR__ . '/../scripts/sqlite2mysql.phar';
-            if (!file_exists($pharPath)) {
-                $this->appendOutput("错误: sqlite2mysql.phar 文件不存在，请重新启动应用程序以自动下载\n");
-                return;
-            }
-
-            // 禁用转换按钮
-            // 注意：SDK中可能没有disable方法，需要重新创建按钮
-
             // 重置进度条
             $this->progressBar->setValue(0);
 
             // 清空输出区域
-            $this->outputArea->setText("开始转换...\n");
-
-            // 构建命令行参数
-            $cmd = "php " . escapeshellarg($pharPath);
-            $cmd .= " --sqlite=" . escapeshellarg($sqliteFile);
-            $cmd .= " --mysql=" . escapeshellarg($mysqlDsn);
-            $cmd .= " --batch-size=" . escapeshellarg((string)$batchSize);
+            $this->output->setText("开始转换...\n");
+
+            // 构建命令行参数，转换在独立进程中进行，进度以 JSON 事件逐行输出
+            // 使用与界面相同的 PHP；以参数数组启动不经过 shell，取消时 SIGTERM 直接发给转换进程
+            $cmd = [PHP_BINARY, __DIR__ . '/../scripts/sqlite2mysql.php'];
+            $cmd[] = "--sqlite=" . $sqliteFile;
+            if ($dumpDir !== '') {
+                $cmd[] = "--dump=" . $dumpDir;
+                $cmd[] = "--format=" . ($this->loadDataCheckbox->isChecked() ? MySQLDumpWriter::FORMAT_TSV : MySQLDumpWriter::FORMAT_SQL);
+            } else {
+                $cmd[] = "--mysql=" . $mysqlDsn;
+            }
+            $cmd[] = "--batch-size=" . $batchSize;
+            $cmd[] = "--workers=" . $workers;
+            $cmd[] = "--json";
 
             if ($dropExisting) {
-                $cmd .= " --drop-existing";
+                $cmd[] = "--drop-existing";
             }
 
             if (!empty($excludeTables)) {
-                $cmd .= " --exclude-tables=" . escapeshellarg($excludeTables);
+                $cmd[] = "--exclude-tables=" . $excludeTables;
             }
 
             // 执行转换命令
-            $this->appendOutput("执行命令: $cmd\n");
+            $this->appendOutput("执行命令: " . implode(' ', array_map('escapeshellarg', $cmd)) . "\n");
 
             // 使用异步方式执行命令，以便更新进度
             $this->executeCommandAsync($cmd);
@@ -301,180 +262,121 @@ class SQLite2MySQLTab
                     "开始转换时发生错误: " . $e->getMessage()
                 );
             }
-
-            // 重新启用转换按钮
-            // 注意：SDK中可能没有enable方法，需要重新创建按钮
-        }
-    }
-
-    private function executeCommandAsync($cmd)
-    {
-        // 在后台执行命令
-        $process = proc_open(
-            $cmd,
-            [
-                0 => ["pipe", "r"],  // stdin
-                1 => ["pipe", "w"],  // stdout
-                2 => ["pipe", "w"]   // stderr
-            ],
-            $pipes
-        );
-
-        if (!is_resource($process)) {
-            $this->appendOutput("错误: 无法启动转换进程\n");
-            // 重新启用转换按钮
-            return;
+            $this->convertButton->setText("开始转换");
         }
-
-        // 关闭 stdin
-        fclose($pipes[0]);
-
-        // 异步读取输出
-        $this->readProcessOutput($process, $pipes);
     }
 
-    private function readProcessOutput($process, $pipes)
+    private function executeCommandAsync(array $cmd)
     {
-        // 读取 stdout 和 stderr
-        $stdout = $pipes[1];
-        $stderr = $pipes[2];
-
-        // 设置非阻塞模式
-        stream_set_blocking($stdout, false);
-        stream_set_blocking($stderr, false);
-
-        // 持续读取输出直到进程结束
-        $outputBuffer = "";
+        $this->progress = ['done' => 0, 'total' => 0, 'start' => microtime(true), 'value' => 0];
         $errorBuffer = "";
 
-        // 进度跟踪变量
-        $totalTables = 0;
-        $processedTables = 0;
-        $totalRecords = 0;
-        $insertedRecords = 0;
-
-        do {
-            // 读取 stdout
-            $stdoutData = fread($stdout, 4096);
-            if ($stdoutData !== false && strlen($stdoutData) > 0) {
-                $outputBuffer .= $stdoutData;
-                $this->appendOutput($stdoutData);
-
-                // 解析输出以更新进度
-                $this->parseOutputForProgress($stdoutData, $totalTables, $processedTables, $totalRecords, $insertedRecords);
+        // 输出由主循环定时读取，界面不会被阻塞
+        $this->process = new LibuiProcess($cmd);
+        $this->process->onLine(function (string $line, string $stream) use (&$errorBuffer) {
+            if ($stream === LibuiProcess::STDOUT) {
+                $event = json_decode($line, true);
+                if (is_array($event) && isset($event['type'])) {
+                    $this->handleConverterEvent($event);
+                    return;
+                }
+                $this->appendOutput($line . "\n");
+            } else {
+                $this->appendOutput($line . "\n");
+                $errorBuffer .= $line . "\n";
             }
-
-            // 读取 stderr
-            $stderrData = fread($stderr, 4096);
-            if ($stderrData !== false && strlen($stderrData) > 0) {
-                $errorBuffer .= $stderrData;
-                $this->appendOutput($stderrData);
+        });
+        $this->process->onExit(function (int $exitCode, LibuiProcess $process) use (&$errorBuffer) {
+            // 显示完成信息
+            if ($process->isCancelled()) {
+                $this->appendOutput("\n转换已取消\n");
+            } elseif ($exitCode === 0) {
+                $this->appendOutput("\n转换完成！\n");
+                $this->progressBar->setValue(100);
+            } else {
+                $this->appendOutput("\n转换失败，退出码: $exitCode\n");
+                if (!empty($errorBuffer)) {
+                    $this->appendOutput("错误信息: $errorBuffer\n");
+                }
             }
+            $this->convertButton->setText("开始转换");
+        });
 
-            // 检查进程状态
-            $status = proc_get_status($process);
-
-            // 短暂休眠以避免占用过多 CPU
-            usleep(100000); // 100ms
-
-        } while ($status['running']);
-
-        // 读取剩余输出
-        while (!feof($stdout)) {
-            $data = fread($stdout, 4096);
-            if ($data !== false && strlen($data) > 0) {
-                $outputBuffer .= $data;
-                $this->appendOutput($data);
-
-                // 解析输出以更新进度
-                $this->parseOutputForProgress($data, $totalTables, $processedTables, $totalRecords, $insertedRecords);
-            }
+        try {
+            $this->process->start();
+        } catch (\RuntimeException $e) {
+            $this->appendOutput("错误: 无法启动转换进程\n");
+            $this->process = null;
+            return;
         }
 
-        while (!feof($stderr)) {
-            $data = fread($stderr, 4096);
-            if ($data !== false && strlen($data) > 0) {
-                $errorBuffer .= $data;
-                $this->appendOutput($data);
-            }
-        }
+        $this->convertButton->setText("取消转换");
+    }
 
-        // 关闭管道
-        fclose($stdout);
-        fclose($stderr);
-
-        // 获取退出码
-        $exitCode = proc_close($process);
-
-        // 显示完成信息
-        if ($exitCode === 0) {
-            $this->appendOutput("\n转换完成！\n");
-            $this->progressBar->setValue(100);
-        } else {
-            $this->appendOutput("\n转换失败，退出码: $exitCode\n");
-            if (!empty($errorBuffer)) {
-                $this->appendOutput("错误信息: $errorBuffer\n");
-            }
+    /**
+     * 处理转换引擎的进度事件（见 SQLiteToMySQLConverter）
+     */
+    private function handleConverterEvent(array $event)
+    {
+        switch ($event['type']) {
+            case 'start':
+                $this->progress['total'] = (int)$event['total'];
+                $this->appendOutput(sprintf("共 %d 张表，%d 行\n", count($event['tables']), $event['total']));
+                break;
+            case 'table_start':
+                $this->appendOutput(sprintf("转换表 %s（%d 行）\n", $event['table'], $event['rows']));
+                break;
+            case 'rows':
+                $this->progress['done'] = (int)$event['done'];
+                $this->scheduleProgressUpdate();
+                break;
+            case 'table_done':
+                $this->appendOutput(sprintf("完成表 %s（%d 行）\n", $event['table'], $event['rows']));
+                break;
+            case 'error':
+                $this->appendOutput(sprintf("错误%s: %s\n", !empty($event['table']) ? "（表 {$event['table']}）" : '', $event['message']));
+                break;
+            case 'done':
+                $this->progress['done'] = (int)$event['done'];
+                $this->scheduleProgressUpdate();
+                $this->appendOutput(sprintf("%d/%d 行，耗时 %.2f 秒\n", $event['done'], $event['total'], $event['seconds']));
+                break;
         }
-
-        // 重新启用转换按钮
-        // 注意：SDK中可能没有enable方法，需要重新创建按钮
     }
 
-    private function parseOutputForProgress($output, &$totalTables, &$processedTables, &$totalRecords, &$insertedRecords)
+    /**
+     * 同一轮主循环内的多个进度事件合并为一次进度条和状态更新
+     */
+    private function scheduleProgressUpdate()
     {
-        // 解析输出以更新进度
-        $lines = explode("\n", $output);
-
-        foreach ($lines as $line) {
-            // 查找总表数
-            if (preg_match('/Processed Tables: (\d+)/', $line, $matches)) {
-                $totalTables = (int)$matches[1];
-            }
-
-            // 查找总记录数
-            if (preg_match('/Total Records: (\d+)/', $line, $matches)) {
-                $totalRecords = (int)$matches[1];
-            }
-
-            // 查找正在处理的表
-            if (preg_match('/Processing table: (.+)/', $line, $matches)) {
-                // 可以在这里增加已处理表的数量，但需要更精确的逻辑
-            }
-
-            // 查找成功转换的表
-            if (preg_match('/Successfully converted table: (.+)/', $line, $matches)) {
-                $processedTables++;
-            }
-
-            // 查找插入的记录数
-            if (preg_match('/Inserted (\d+) rows into table/', $line, $matches)) {
-                $insertedRecords += (int)$matches[1];
-            }
+        if ($this->progressScheduled) {
+            return;
         }
+        $this->progressScheduled = true;
+        $this->progressCallback ??= LibuiCallback::queue(
+            LibuiApplication::getInstance()->getProfiler()->wrap('queueMain SQLite2MySQLTab::updateProgress', function () {
+                $this->updateProgress();
+            }, 'queueMain')
+        );
+        $this->progressCallback->queueMain();
+    }
 
-        // 计算进度百分比
-        $progress = 0;
-        if ($totalRecords > 0) {
-            // 基于插入记录数计算进度
-            $progress = min(100, ($insertedRecords / $totalRecords) * 100);
-        } else if ($totalTables > 0) {
-            // 基于处理表数计算进度
-            $progress = min(100, ($processedTables / $totalTables) * 100);
+    private function updateProgress()
+    {
+        $this->progressScheduled = false;
+        $total = $this->progress['total'];
+        $value = $total > 0 ? (int)min(100, $this->progress['done'] * 100 / $total) : 0;
+        if ($value !== $this->progressBar->getValue()) {
+            $this->progressBar->setValue($value);
         }
-
-        // 更新进度条
-        $this->progressBar->setValue((int)$progress);
+        $elapsed = max(0.001, microtime(true) - $this->progress['start']);
+        $this->statusLabel->setText(sprintf("已转换 %d/%d 行，%d 行/秒", $this->progress['done'], $total, $this->progress['done'] / $elapsed));
     }
 
     private function appendOutput($text)
     {
-        $currentText = $this->outputArea->getText();
-        $newText = $currentText . $text;
-        $this->outputArea->setText($newText);
-
-        // 滚动到底部
-        // 注意：libui PHP 绑定可能不支持直接滚动到底部
+        // 日志缓冲每个主循环周期最多刷新一次文本框，且只追加新内容
+        $this->output->append($text);
     }
 
     private function selectSqliteFile()
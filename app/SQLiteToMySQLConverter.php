@@ -0,0 +1,427 @@
+<?php
+
+namespace App;
+
+use PDO;
+
+/**
+ * SQLite 到 MySQL 转换引擎
+ *
+ * 用游标逐行读取 SQLite（不会把整张表读入内存），按 batchSize 分批交给 MySQLWriter；
+ * 有 pcntl 扩展时，多张表按行数分配给多个工作进程并行转换。
+ * 进度通过结构化事件回调报告：
+ *   ['type' => 'start', 'tables' => [表名 => 行数], 'total' => 总行数]
+ *   ['type' => 'table_start', 'table' => 表名, 'rows' => 行数]
+ *   ['type' => 'rows', 'table' => 表名, 'rows' => 本批行数, 'done' => 已完成总行数, 'total' => 总行数]
+ *   ['type' => 'table_done', 'table' => 表名, 'rows' => 实际写入行数]
+ *   ['type' => 'error', 'table' => 表名, 'message' => 错误信息]
+ *   ['type' => 'worker_done', 'pid' => 进程号, 'peak_memory' => 峰值内存字节数]
+ *   ['type' => 'done', 'success' => bool, 'done' => 已完成总行数, 'total' => 总行数, 'seconds' => 耗时]
+ *
+ * 多进程模式会 fork 当前进程，应在 CLI 进程中调用（界面通过 scripts/sqlite2mysql.php 调用）。
+ */
+class SQLiteToMySQLConverter
+{
+    private string $sqliteFile;
+    private $writerFactory;
+    private int $batchSize = 1000;
+    private array $excludeTables = [];
+    private bool $dropExisting = false;
+    private int $workers = 1;
+    private array $workerPids = []; // 并行模式下尚未回收的工作进程
+
+    private array $listeners = [];
+    private array $tables = [];
+    private int $totalRows = 0;
+    private int $doneRows = 0;
+
+    /**
+     * @param string $sqliteFile SQLite 文件路径
+     * @param callable $writerFactory function(): MySQLWriter，每个工作进程调用一次
+     * @param array $options batchSize、excludeTables、dropExisting、workers
+     */
+    public function __construct(string $sqliteFile, callable $writerFactory, array $options = [])
+    {
+        $this->sqliteFile = $sqliteFile;
+        $this->writerFactory = $writerFactory;
+        $this->batchSize = max(1, (int)($options['batchSize'] ?? $this->batchSize));
+        $this->excludeTables = array_filter(array_map('trim', (array)($options['excludeTables'] ?? [])), 'strlen');
+        $this->dropExisting = (bool)($options['dropExisting'] ?? false);
+        $this->workers = max(1, (int)($options['workers'] ?? $this->workers));
+    }
+
+    /**
+     * MySQL 标识符加反引号
+     */
+    public static function quoteIdentifier(string $name): string
+    {
+        return '`' . str_replace('`', '``', $name) . '`';
+    }
+
+    /**
+     * 根据输出目标创建 writer 工厂：mysql:// 连接字符串或导出目录
+     */
+    public static function createWriterFactory(string $target, string $format = MySQLDumpWriter::FORMAT_SQL, int $batchSize = 1000): callable
+    {
+        if (str_starts_with($target, 'mysql://')) {
+            return function () use ($target, $batchSize) {
+                return MySQLPdoWriter::fromDsn($target, $batchSize);
+            };
+        }
+        return function () use ($target, $format) {
+            return new MySQLDumpWriter($target, $format);
+        };
+    }
+
+    public function onEvent(callable $listener): self
+    {
+        $this->listeners[] = $listener;
+        return $this;
+    }
+
+    /**
+     * 读取要转换的表结构和行数
+     *
+     * @return array 表名 => ['columns' => [列名 => MySQL 类型], 'create' => 建表语句, 'rows' => 行数]
+     */
+    public function inspect(): array
+    {
+        $pdo = $this->openSqlite();
+        $names = $pdo->query("SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name")
+            ->fetchAll(PDO::FETCH_COLUMN);
+
+        $tables = [];
+        foreach ($names as $name) {
+            if (in_array($name, $this->excludeTables, true)) {
+                continue;
+            }
+            $tables[$name] = $this->describeTable($pdo, $name);
+            $tables[$name]['rows'] = (int)$pdo->query('SELECT COUNT(*) FROM ' . $this->quoteSqlite($name))->fetchColumn();
+        }
+        return $tables;
+    }
+
+    public function getTables(): array
+    {
+        return $this->tables;
+    }
+
+    /**
+     * 执行转换
+     *
+     * @return bool 所有表是否都转换成功
+     */
+    public function run(): bool
+    {
+        $start = microtime(true);
+        $this->tables = $this->inspect();
+        $this->totalRows = array_sum(array_column($this->tables, 'rows'));
+        $this->doneRows = 0;
+
+        $this->dispatch([
+            'type' => 'start',
+            'tables' => array_map(fn($info) => $info['rows'], $this->tables),
+            'total' => $this->totalRows,
+        ]);
+
+        $workers = min($this->workers, count($this->tables));
+        if ($workers > 1 && function_exists('pcntl_fork') && function_exists('stream_socket_pair')) {
+            $success = $this->runParallel($workers);
+        } else {
+            $success = $this->convertTables(array_keys($this->tables), function (array $event) {
+                $this->dispatch($event);
+            });
+        }
+
+        $this->dispatch([
+            'type' => 'done',
+            'success' => $success,
+            'done' => $this->doneRows,
+            'total' => $this->totalRows,
+            'seconds' => round(microtime(true) - $start, 3),
+        ]);
+        return $success;
+    }
+
+    /**
+     * 按行数从大到小把表分配给当前负载最小的工作进程，各进程通过 socket 回传事件
+     */
+    private function runParallel(int $workers): bool
+    {
+        $byRows = array_map(fn($info) => $info['rows'], $this->tables);
+        arsort($byRows);
+        $assignments = array_fill(0, $workers, []);
+        $load = array_fill(0, $workers, 0);
+        foreach ($byRows as $table => $rows) {
+            $worker = array_keys($load, min($load))[0];
+            $assignments[$worker][] = $table;
+            $load[$worker] += $rows + 1;
+        }
+
+        $sockets = [];
+        foreach ($assignments as $tables) {
+            [$parentSocket, $childSocket] = stream_socket_pair(STREAM_PF_UNIX, STREAM_SOCK_STREAM, STREAM_IPPROTO_IP);
+            $pid = pcntl_fork();
+            if ($pid === -1) {
+                throw new \RuntimeException("无法创建工作进程");
+            }
+            if ($pid === 0) {
+                fclose($parentSocket);
+                $this->runWorker($tables, $childSocket);
+            }
+            fclose($childSocket);
+            $sockets[$pid] = $parentSocket;
+            $this->workerPids[] = $pid;
+        }
+
+        // 汇总各工作进程的事件
+        $buffers = [];
+        while (!empty($sockets)) {
+            $read = array_values($sockets);
+            $write = null;
+            $except = null;
+            if (@stream_select($read, $write, $except, 1) === false) {
+                break;
+            }
+            foreach ($read as $socket) {
+                $pid = array_search($socket, $sockets, true);
+                $data = fread($socket, 65536);
+                if ($data === false || $data === '') {
+                    if (feof($socket)) {
+                        fclose($socket);
+                        unset($sockets[$pid]);
+                    }
+                    continue;
+                }
+                $buffers[$pid] = ($buffers[$pid] ?? '') . $data;
+                while (($end = strpos($buffers[$pid], "\n")) !== false) {
+                    $event = json_decode(substr($buffers[$pid], 0, $end), true);
+                    $buffers[$pid] = substr($buffers[$pid], $end + 1);
+                    if (is_array($event)) {
+                        $this->dispatch($event);
+                    }
+                }
+            }
+        }
+
+        $success = true;
+        foreach ($this->workerPids as $pid) {
+            pcntl_waitpid($pid, $status);
+            if (!pcntl_wifexited($status) || pcntl_wexitstatus($status) !== 0) {
+                $success = false;
+            }
+        }
+        $this->workerPids = [];
+        return $success;
+    }
+
+    /**
+     * 工作进程：转换分配的表，事件写入 socket，任何情况下都以 exit 结束，不回到调用方
+     */
+    private function runWorker(array $tables, $socket): never
+    {
+        // 父进程安装的信号处理不适用于工作进程，收到 SIGTERM 时直接结束
+        if (function_exists('pcntl_signal')) {
+            pcntl_signal(SIGTERM, SIG_DFL);
+            pcntl_signal(SIGINT, SIG_DFL);
+        }
+
+        $send = function (array $event) use ($socket) {
+            // 父进程已经退出时不再继续写入
+            if (@fwrite($socket, json_encode($event, JSON_INVALID_UTF8_SUBSTITUTE) . "\n") === false) {
+                exit(1);
+            }
+        };
+
+        $ok = false;
+        try {
+            $ok = $this->convertTables($tables, $send);
+        } catch (\Throwable $e) {
+            $send(['type' => 'error', 'table' => null, 'message' => $e->getMessage()]);
+        }
+        $send([
+            'type' => 'worker_done',
+            'pid' => getmypid(),
+            'peak_memory' => memory_get_peak_usage(true),
+        ]);
+        fclose($socket);
+        exit($ok ? 0 : 1);
+    }
+
+    /**
+     * 结束并回收所有工作进程（命令行入口收到 SIGTERM/SIGINT 时调用）
+     */
+    public function terminateWorkers(): void
+    {
+        if (function_exists('posix_kill')) {
+            foreach ($this->workerPids as $pid) {
+                posix_kill($pid, SIGTERM);
+            }
+        }
+        foreach ($this->workerPids as $pid) {
+            pcntl_waitpid($pid, $status);
+        }
+        $this->workerPids = [];
+    }
+
+    /**
+     * 在当前进程中依次转换若干张表
+     */
+    private function convertTables(array $tables, callable $emit): bool
+    {
+        $success = true;
+        $sqlite = $this->openSqlite();
+        $writer = ($this->writerFactory)();
+        foreach ($tables as $table) {
+            try {
+                $this->convertTable($sqlite, $writer, $table, $emit);
+            } catch (\Throwable $e) {
+                $success = false;
+                $emit(['type' => 'error', 'table' => $table, 'message' => $e->getMessage()]);
+                try {
+                    $writer->abortTable();
+                } catch (\Throwable $abortError) {
+                    // 连接已断开等情况下回滚也会失败，未提交的数据由服务器丢弃
+                }
+            }
+        }
+        $writer->close();
+        return $success;
+    }
+
+    private function convertTable(PDO $sqlite, MySQLWriter $writer, string $table, callable $emit): void
+    {
+        $info = $this->tables[$table];
+        $emit(['type' => 'table_start', 'table' => $table, 'rows' => $info['rows']]);
+        $writer->beginTable($table, $info['create'], $info['columns'], $this->dropExisting);
+
+        $columns = implode(', ', array_map([$this, 'quoteSqlite'], array_keys($info['columns'])));
+        $statement = $sqlite->query("SELECT $columns FROM " . $this->quoteSqlite($table), PDO::FETCH_NUM);
+
+        // pdo_sqlite 逐行 step，内存中只保留当前这一批
+        $written = 0;
+        $batch = [];
+        $count = 0;
+        foreach ($statement as $row) {
+            $batch[] = $row;
+            if (++$count === $this->batchSize) {
+                $writer->writeRows($batch);
+                $written += $count;
+                $emit(['type' => 'rows', 'table' => $table, 'rows' => $count]);
+                $batch = [];
+                $count = 0;
+            }
+        }
+        if ($count > 0) {
+            $writer->writeRows($batch);
+            $written += $count;
+            $emit(['type' => 'rows', 'table' => $table, 'rows' => $count]);
+        }
+        $statement->closeCursor();
+
+        $writer->endTable();
+        $emit(['type' => 'table_done', 'table' => $table, 'rows' => $written]);
+    }
+
+    /**
+     * 补充汇总进度后通知监听者
+     */
+    private function dispatch(array $event): void
+    {
+        if ($event['type'] === 'rows') {
+            $this->doneRows += $event['rows'];
+            $event['done'] = $this->doneRows;
+            $event['total'] = $this->totalRows;
+        }
+        foreach ($this->listeners as $listener) {
+            $listener($event);
+        }
+    }
+
+    /**
+     * 生成 MySQL 建表语句
+     */
+    private function describeTable(PDO $pdo, string $table): array
+    {
+        $columns = [];
+        $definitions = [];
+        $primaryKey = [];
+        foreach ($pdo->query('PRAGMA table_info(' . $this->quoteSqlite($table) . ')', PDO::FETCH_ASSOC) as $column) {
+            $type = self::mapType((string)$column['type'], $column['pk'] > 0);
+            $columns[$column['name']] = $type;
+            $definitions[] = self::quoteIdentifier($column['name']) . ' ' . $type . ($column['notnull'] ? ' NOT NULL' : '');
+            if ($column['pk'] > 0) {
+                $primaryKey[(int)$column['pk']] = self::quoteIdentifier($column['name']);
+            }
+        }
+        if (!empty($primaryKey)) {
+            ksort($primaryKey);
+            $definitions[] = 'PRIMARY KEY (' . implode(', ', $primaryKey) . ')';
+        }
+
+        return [
+            'columns' => $columns,
+            'create' => 'CREATE TABLE IF NOT EXISTS ' . self::quoteIdentifier($table)
+                . " (\n  " . implode(",\n  ", $definitions) . "\n) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4",
+        ];
+    }
+
+    /**
+     * SQLite 声明类型转换为 MySQL 类型（按 SQLite 类型亲和性规则）
+     *
+     * 主键列不能是 TEXT/BLOB，改用有长度的类型
+     */
+    public static function mapType(string $declared, bool $key = false): string
+    {
+        $type = strtoupper(trim($declared));
+        if (str_contains($type, 'BOOL')) {
+            return 'TINYINT(1)';
+        }
+        if (str_contains($type, 'INT')) {
+            return 'BIGINT';
+        }
+        if (str_contains($type, 'CHAR') || str_contains($type, 'CLOB') || str_contains($type, 'TEXT')) {
+            return $key ? 'VARCHAR(255)' : 'LONGTEXT';
+        }
+        if (str_contains($type, 'BLOB')) {
+            return $key ? 'VARBINARY(255)' : 'LONGBLOB';
+        }
+        if (str_contains($type, 'REAL') || str_contains($type, 'FLOA') || str_contains($type, 'DOUB')) {
+            return 'DOUBLE';
+        }
+        if (preg_match('/^(DECIMAL|NUMERIC)\s*\((\d+)\s*(?:,\s*(\d+))?\)/', $type, $matches)
+            && (int)$matches[2] >= 1 && (int)$matches[2] <= 65) {
+            $precision = (int)$matches[2];
+            return sprintf('DECIMAL(%d,%d)', $precision, min(30, $precision, (int)($matches[3] ?? 0)));
+        }
+        if (str_contains($type, 'DEC') || str_contains($type, 'NUMERIC')) {
+            return 'DECIMAL(65,10)';
+        }
+        if (str_contains($type, 'DATETIME') || str_contains($type, 'TIMESTAMP')) {
+            return 'DATETIME';
+        }
+        if (str_contains($type, 'DATE')) {
+            return 'DATE';
+        }
+        if (str_contains($type, 'TIME')) {
+            return 'TIME';
+        }
+        // 未声明类型的列可以存放任意值
+        return $key ? 'VARCHAR(255)' : 'LONGTEXT';
+    }
+
+    private function openSqlite(): PDO
+    {
+        if (!is_readable($this->sqliteFile)) {
+            throw new \RuntimeException("SQLite 文件不存在或不可读: {$this->sqliteFile}");
+        }
+        $pdo = new PDO('sqlite:' . $this->sqliteFile, null, null, [PDO::ATTR_ERRMODE => PDO::ERRMODE_EXCEPTION]);
+        $pdo->exec('PRAGMA query_only = 1');
+        return $pdo;
+    }
+
+    private function quoteSqlite(string $name): string
+    {
+        return '"' . str_replace('"', '""', $name) . '"';
+    }
+}
@@ -0,0 +1,166 @@
+<?php
+
+/**
+ * 绘图基准测试：每帧重建路径（立即模式） vs 保留模式显示列表
+ *
+ * 用法: php benchmarks/draw_scene.php [--points=5000] [--series=4] [--markers=2000] [--seconds=5]
+ *
+ * 在 4000 像素宽的滚动区域中放置 markers 个静态标记和 series 条实时折线（每条 points 个点），
+ * 每 16 毫秒向每条折线追加新数据，报告实际帧率和每帧绘制耗时。需要图形环境。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use Kingbes\Libui\SDK\LibuiApplication;
+use Kingbes\Libui\SDK\LibuiBrush;
+use Kingbes\Libui\SDK\LibuiDrawArea;
+use Kingbes\Libui\SDK\LibuiDrawContext;
+use Kingbes\Libui\SDK\LibuiLineSeries;
+use Kingbes\Libui\SDK\LibuiPath;
+use Kingbes\Libui\SDK\LibuiScene;
+use Kingbes\Libui\SDK\LibuiSceneNode;
+use Kingbes\Libui\SDK\LibuiStrokeParams;
+use Kingbes\Libui\SDK\LibuiWindow;
+
+$options = getopt('', ['points::', 'series::', 'markers::', 'seconds::', 'mode:']);
+$points = max(2, (int)($options['points'] ?? 5000));
+$seriesCount = max(1, (int)($options['series'] ?? 4));
+$markerCount = max(0, (int)($options['markers'] ?? 2000));
+$seconds = max(1, (int)($options['seconds'] ?? 5));
+
+const CANVAS_WIDTH = 4000;
+const VIEW_WIDTH = 1000;
+const VIEW_HEIGHT = 600;
+
+// 子进程：运行单个模式，输出一行 JSON 结果
+if (isset($options['mode'])) {
+    $mode = $options['mode'];
+    mt_srand(7);
+
+    $app = LibuiApplication::getInstance()->init();
+    $window = new LibuiWindow("draw benchmark: $mode", VIEW_WIDTH, VIEW_HEIGHT);
+    $area = new LibuiDrawArea(CANVAS_WIDTH, VIEW_HEIGHT, true);
+    $window->setChild($area);
+
+    // 静态标记均匀分布在整个画布上，折线位于第一屏
+    $markers = [];
+    for ($i = 0; $i < $markerCount; $i++) {
+        $markers[] = [mt_rand(0, CANVAS_WIDTH - 8), mt_rand(0, VIEW_HEIGHT - 8)];
+    }
+    $series = [];
+    $bandHeight = (VIEW_HEIGHT - 20) / $seriesCount;
+    for ($s = 0; $s < $seriesCount; $s++) {
+        $data = [];
+        for ($i = 0; $i < $points; $i++) {
+            $data[] = sin($i / 50 + $s) * 50 + mt_rand(0, 20);
+        }
+        $series[] = $data;
+    }
+
+    $frames = 0;
+    $drawNs = 0;
+    $tick = 0;
+
+    if ($mode === 'scene') {
+        $scene = new LibuiScene();
+        foreach ($markers as [$x, $y]) {
+            $scene->add((new LibuiSceneNode())->rectangle($x, $y, 8, 8)->setFill(0.9, 0.4, 0.1));
+        }
+        $lines = [];
+        foreach ($series as $s => $data) {
+            $line = (new LibuiLineSeries(10, 10 + $s * $bandHeight, VIEW_WIDTH - 20, $bandHeight - 10, $points))->setData($data);
+            $lines[] = $line;
+            $scene->add($line);
+        }
+        $area->setScene($scene);
+        $area->onDraw(function () use ($scene, &$frames, &$drawNs) {
+            $frames++;
+            $drawNs += (int)($scene->getStats()['ms'] * 1e6);
+        });
+        $update = function () use ($lines, &$tick) {
+            foreach ($lines as $s => $line) {
+                $values = [];
+                for ($i = 0; $i < 10; $i++, $tick++) {
+                    $values[] = sin($tick / 50 + $s) * 50 + mt_rand(0, 20);
+                }
+                $line->push(...$values);
+            }
+        };
+    } else {
+        // 立即模式：每帧为每个标记和每条折线的每个点重新创建路径
+        $markerBrush = new LibuiBrush(0.9, 0.4, 0.1);
+        $lineBrush = new LibuiBrush(0.2, 0.5, 0.9);
+        $stroke = new LibuiStrokeParams(1.5);
+        $area->onDraw(function (LibuiDrawContext $context) use (&$series, $markers, $markerBrush, $lineBrush, $stroke, $bandHeight, &$frames, &$drawNs) {
+            $start = hrtime(true);
+            foreach ($markers as [$x, $y]) {
+                $path = new LibuiPath();
+                $path->rectangle($x, $y, 8, 8)->end();
+                $context->fill($path, $markerBrush);
+            }
+            foreach ($series as $s => $data) {
+                $min = min($data);
+                $range = max($data) - $min ?: 1;
+                $top = 10 + $s * $bandHeight;
+                $step = (VIEW_WIDTH - 20) / (count($data) - 1);
+                $path = new LibuiPath();
+                $path->newFigure(10, $top + ($bandHeight - 10) * (1 - ($data[0] - $min) / $range));
+                foreach ($data as $i => $value) {
+                    $path->lineTo(10 + $i * $step, $top + ($bandHeight - 10) * (1 - ($value - $min) / $range));
+                }
+                $path->end();
+                $context->stroke($path, $lineBrush, $stroke);
+            }
+            $frames++;
+            $drawNs += hrtime(true) - $start;
+        });
+        $update = function () use (&$series, $area, &$tick) {
+            foreach ($series as $s => &$data) {
+                for ($i = 0; $i < 10; $i++, $tick++) {
+                    array_shift($data);
+                    $data[] = sin($tick / 50 + $s) * 50 + mt_rand(0, 20);
+                }
+            }
+            unset($data);
+            $area->redraw();
+        };
+    }
+
+    $window->show();
+    $start = microtime(true);
+    $app->timer(16, function () use ($update, $start, $seconds, $app) {
+        if (microtime(true) - $start >= $seconds) {
+            $app->quit();
+            return false;
+        }
+        $update();
+        return true;
+    });
+    $app->run();
+
+    $elapsed = microtime(true) - $start;
+    echo json_encode([
+        'fps' => $frames / $elapsed,
+        'draw_ms' => $frames ? $drawNs / $frames / 1e6 : 0,
+        'frames' => $frames,
+    ]), "\n";
+    exit(0);
+}
+
+if (PHP_OS_FAMILY === 'Linux' && !getenv('DISPLAY') && !getenv('WAYLAND_DISPLAY')) {
+    fwrite(STDERR, "需要图形环境（可以在 xvfb-run 下运行）\n");
+    exit(1);
+}
+
+printf("%d series x %d points, %d markers, %d s per mode\n\n", $seriesCount, $points, $markerCount, $seconds);
+printf("%-12s %8s %14s %8s\n", 'mode', 'fps', 'ms per frame', 'frames');
+foreach (['immediate', 'scene'] as $mode) {
+    $command = escapeshellarg(PHP_BINARY) . ' ' . escapeshellarg(__FILE__)
+        . " --mode=$mode --points=$points --series=$seriesCount --markers=$markerCount --seconds=$seconds 2>/dev/null";
+    $result = json_decode((string)shell_exec($command), true);
+    if (!is_array($result)) {
+        printf("%-12s %8s\n", $mode, 'failed');
+        continue;
+    }
+    printf("%-12s %8.1f %14.2f %8d\n", $mode, $result['fps'], $result['draw_ms'], $result['frames']);
+}
@@ -0,0 +1,142 @@
+<?php
+
+/**
+ * 事件分发基准测试：旧 EventManager（按优先级嵌套数组 + 每次 emit 记录日志） vs 编译后的扁平监听器列表
+ *
+ * 用法: php benchmarks/event_dispatch.php [--emits=200000] [--burst=200]
+ *
+ * 不需要图形环境：合并订阅的 uiQueueMain 回调用数组队列代替，每一"帧"结束时手动执行。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use Kingbes\Libui\SDK\EventManager;
+use Kingbes\Libui\SDK\LibuiComponent;
+use Psr\Log\LoggerInterface;
+use Psr\Log\NullLogger;
+
+/**
+ * 优化前的 EventManager 实现，仅用于对比
+ */
+class LegacyEventManager
+{
+    private array $listeners = [];
+    private ?LoggerInterface $logger = null;
+
+    private function getLogger(): LoggerInterface {
+        return $this->logger ??= new NullLogger();
+    }
+
+    public function on(string $event, callable $callback, int $priority = 0): string {
+        $id = uniqid('listener_');
+        $this->listeners[$event][$priority][$id] = $callback;
+        krsort($this->listeners[$event]);
+        $this->getLogger()->debug("Event listener registered", [
+            'event' => $event,
+            'listener_id' => $id,
+            'priority' => $priority
+        ]);
+        return $id;
+    }
+
+    public function emit(string $event, LibuiComponent $source, mixed $data = null): void {
+        $this->getLogger()->debug("Event emitted", [
+            'event' => $event,
+            'source' => get_class($source),
+            'source_id' => $source->getId()
+        ]);
+        foreach ($this->listeners[$event] ?? [] as $priority => $callbacks) {
+            foreach ($callbacks as $callback) {
+                try {
+                    $callback($source, $data);
+                } catch (\Throwable $e) {
+                    $this->getLogger()->error("Event listener error", ['event' => $event, 'error' => $e->getMessage()]);
+                }
+            }
+        }
+    }
+}
+
+$options = getopt('', ['emits::', 'burst::']);
+$emits = max(1, (int)($options['emits'] ?? 200000));
+$burst = max(1, (int)($options['burst'] ?? 200));
+
+// 只用作事件源，不创建 libui 控件
+$source = new class extends LibuiComponent {
+    protected function createHandle(): \FFI\CData {
+        throw new \LogicException('headless source');
+    }
+};
+
+/**
+ * 返回每秒 emit 次数
+ */
+function measure(object $manager, string $event, LibuiComponent $source, int $emits): float {
+    $start = hrtime(true);
+    for ($i = 0; $i < $emits; $i++) {
+        $manager->emit($event, $source, $i);
+    }
+    return $emits / ((hrtime(true) - $start) / 1e9);
+}
+
+printf("%d emits per case\n\n", $emits);
+printf("%-24s %14s %14s %8s\n", 'case', 'legacy/s', 'compiled/s', 'speedup');
+foreach (['1 listener' => 1, '10 listeners, 3 prios' => 10] as $name => $listeners) {
+    $legacy = new LegacyEventManager();
+    $compiled = new EventManager();
+    $sum = 0;
+    for ($i = 0; $i < $listeners; $i++) {
+        $callback = function ($source, $data) use (&$sum) {
+            $sum += $data;
+        };
+        $legacy->on('bench', $callback, $i % 3);
+        $compiled->on('bench', $callback, $i % 3);
+    }
+    $legacyRate = measure($legacy, 'bench', $source, $emits);
+    $compiledRate = measure($compiled, 'bench', $source, $emits);
+    printf("%-24s %14.0f %14.0f %7.1fx\n", $name, $legacyRate, $compiledRate, $compiledRate / $legacyRate);
+}
+
+// 模拟拖动滑块：每帧连续触发 $burst 次，监听器做一次较重的计算
+$queue = [];
+$manager = new EventManager();
+$manager->setScheduler(
+    function (callable $callback) use (&$queue) {
+        $queue[] = $callback;
+    },
+    function (int $milliseconds, callable $callback) use (&$queue) {
+        $queue[] = $callback;
+    }
+);
+$work = function ($source, $value) use (&$calls) {
+    $calls++;
+    $config = '';
+    for ($i = 0; $i < 50; $i++) {
+        $config .= sprintf("pm.max_children = %d\n", $value + $i);
+    }
+    return md5($config);
+};
+
+$frames = max(1, intdiv($emits, $burst));
+$results = [];
+foreach (['direct' => 'on', 'coalesced' => 'onCoalesced'] as $name => $method) {
+    $calls = 0;
+    $id = $manager->$method('slider', $work);
+    $start = hrtime(true);
+    for ($frame = 0; $frame < $frames; $frame++) {
+        for ($i = 0; $i < $burst; $i++) {
+            $manager->emit('slider', $source, $i);
+        }
+        while ($queue) {
+            array_shift($queue)();
+        }
+    }
+    $results[$name] = [(hrtime(true) - $start) / 1e6, $calls];
+    $manager->off('slider', $id);
+}
+
+printf("\nslider drag: %d frames x %d emits\n", $frames, $burst);
+printf("%-24s %14s %14s\n", 'listener', 'total ms', 'handler calls');
+foreach ($results as $name => [$ms, $calls]) {
+    printf("%-24s %14.1f %14d\n", $name, $ms, $calls);
+}
@@ -0,0 +1,151 @@
+<?php
+
+/**
+ * 打包耗时基准测试：全量打包（旧实现） vs 增量打包
+ *
+ * 用法: php benchmarks/incremental_build.php [--files=5000] [--workers=4] [--link=hardlink|reflink|copy] [--keep]
+ *
+ * 生成一个模拟的 vendor 目录，分别测量三种情况下复制 vendor、创建 PHAR 和源码 ZIP 的耗时：
+ * 首次打包、没有任何改动的重新打包、只改动一个文件的重新打包。
+ * 创建 PHAR 需要 phar.readonly=0，未设置时会自动以该配置重新执行本脚本。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use App\IncrementalBuilder;
+
+if (ini_get('phar.readonly')) {
+    passthru(escapeshellarg(PHP_BINARY) . ' -d phar.readonly=0 ' . implode(' ', array_map('escapeshellarg', $argv)), $code);
+    exit($code);
+}
+
+$options = getopt('', ['files::', 'workers::', 'link::', 'keep']);
+$fileCount = max(1, (int)($options['files'] ?? 5000));
+$workers = max(1, (int)($options['workers'] ?? 4));
+$linkMode = $options['link'] ?? IncrementalBuilder::LINK_HARDLINK;
+
+$workDir = sys_get_temp_dir() . '/incremental-build-bench-' . getmypid();
+$sourceDir = $workDir . '/project';
+mkdir($sourceDir . '/vendor', 0755, true);
+
+// 生成测试数据：每个包一个目录，文件大小 1~20 KB 的 PHP 源码
+mt_srand(42);
+$start = microtime(true);
+file_put_contents($sourceDir . '/app.php', "<?php\nrequire __DIR__ . '/vendor/autoload.php';\necho 'hello';\n");
+for ($i = 0; $i < $fileCount; $i++) {
+    $dir = sprintf('%s/vendor/package%03d/src', $sourceDir, $i % 200);
+    if (!is_dir($dir)) {
+        mkdir($dir, 0755, true);
+    }
+    $body = '';
+    $lines = mt_rand(30, 600);
+    for ($line = 0; $line < $lines; $line++) {
+        $body .= sprintf("    public function method%d(\$value) { return \$value * %d + %d; }\n", $line, mt_rand(), $i);
+    }
+    file_put_contents(sprintf('%s/Class%05d.php', $dir, $i), "<?php\n\nclass Class$i\n{\n$body}\n");
+}
+$changedFile = $sourceDir . '/vendor/package000/src/Class00000.php';
+printf("generated %d files in %.1f s\n\n", $fileCount, microtime(true) - $start);
+
+/**
+ * 旧实现：删除后整体复制，buildFromDirectory 创建 PHAR，ZipArchive 打包整个目录
+ */
+function legacyBuild(string $sourceDir, string $appDir): void
+{
+    if (is_dir($appDir)) {
+        exec('rm -rf ' . escapeshellarg($appDir));
+    }
+    mkdir($appDir, 0755, true);
+    copy($sourceDir . '/app.php', $appDir . '/app.php');
+    exec('cp -r ' . escapeshellarg($sourceDir . '/vendor') . ' ' . escapeshellarg($appDir . '/vendor'));
+
+    $pharFile = $appDir . '/app.phar';
+    $phar = new Phar($pharFile);
+    $phar->startBuffering();
+    $phar->addFile($sourceDir . '/app.php', 'app.php');
+    $phar->buildFromDirectory($sourceDir . '/vendor', '/vendor/');
+    $phar->setStub("#!/usr/bin/env php\n<?php\nPhar::mapPhar();\ninclude 'phar://app.phar/app.php';\n__HALT_COMPILER();\n");
+    $phar->stopBuffering();
+    unset($phar);
+
+    $zip = new ZipArchive();
+    $zip->open($appDir . '/app_source.zip', ZipArchive::CREATE | ZipArchive::OVERWRITE);
+    $iterator = new RecursiveIteratorIterator(
+        new RecursiveDirectoryIterator($appDir, FilesystemIterator::SKIP_DOTS),
+        RecursiveIteratorIterator::SELF_FIRST
+    );
+    foreach ($iterator as $path => $info) {
+        $name = substr($path, strlen($appDir) + 1);
+        if ($name === 'app_source.zip') {
+            continue;
+        }
+        $info->isDir() ? $zip->addEmptyDir($name) : $zip->addFile($path, $name);
+    }
+    $zip->close();
+}
+
+/**
+ * 新实现：与打包工具相同的增量流程
+ */
+function incrementalBuild(string $sourceDir, string $appDir, string $stateDir, string $linkMode, int $workers): array
+{
+    $builder = new IncrementalBuilder($stateDir, $linkMode, $workers);
+    if (!is_dir($appDir)) {
+        mkdir($appDir, 0755, true);
+    }
+    $builder->syncFile($sourceDir . '/app.php', $appDir . '/app.php', 'app.php');
+    $builder->syncDirectory($sourceDir . '/vendor', $appDir . '/vendor', 'vendor');
+    $builder->buildPhar(
+        $appDir . '/app.phar',
+        ['app.php' => $sourceDir . '/app.php'] + IncrementalBuilder::listFiles($sourceDir . '/vendor'),
+        "#!/usr/bin/env php\n<?php\nPhar::mapPhar();\ninclude 'phar://app.phar/app.php';\n__HALT_COMPILER();\n"
+    );
+    $builder->buildZip($appDir . '/app_source.zip', $appDir);
+    $builder->save();
+    return $builder->getStats();
+}
+
+/**
+ * 修改一个文件的内容，并确保修改时间与之前不同
+ */
+function touchChangedFile(string $file, int $round): void
+{
+    file_put_contents($file, "// change $round\n", FILE_APPEND);
+    touch($file, time() + $round);
+    clearstatcache();
+}
+
+function measure(callable $build): array
+{
+    $start = microtime(true);
+    $stats = $build();
+    return [microtime(true) - $start, $stats];
+}
+
+$legacyDir = $workDir . '/legacy/app';
+$appDir = $workDir . '/incremental/app';
+$stateDir = $workDir . '/incremental/.app.build';
+
+$results = [];
+foreach (['cold', 'no-op', 'one file changed'] as $round => $label) {
+    if ($round === 2) {
+        touchChangedFile($changedFile, $round);
+    }
+    [$legacySeconds] = measure(fn() => legacyBuild($sourceDir, $legacyDir));
+    [$incrementalSeconds, $stats] = measure(fn() => incrementalBuild($sourceDir, $appDir, $stateDir, $linkMode, $workers));
+    $results[$label] = [$legacySeconds, $incrementalSeconds, $stats];
+}
+
+printf("%-18s %10s %12s %9s %8s %8s %8s %10s %10s\n",
+    'build', 'legacy s', 'incremental s', 'speedup', 'linked', 'copied', 'hashed', 'zip new', 'zip reuse');
+foreach ($results as $label => [$legacySeconds, $incrementalSeconds, $stats]) {
+    printf("%-18s %10.2f %12.2f %8.1fx %8d %8d %8d %10d %10d\n",
+        $label, $legacySeconds, $incrementalSeconds, $legacySeconds / max(0.001, $incrementalSeconds),
+        $stats['linked'], $stats['copied'], $stats['hashed'], $stats['zip_compressed'], $stats['zip_reused']);
+}
+
+if (isset($options['keep'])) {
+    echo "\noutput kept in $workDir\n";
+} else {
+    exec('rm -rf ' . escapeshellarg($workDir));
+}
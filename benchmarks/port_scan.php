@@ -0,0 +1,182 @@
+<?php
+
+/**
+ * 端口扫描基准测试：lsof + 逐PID ps（旧实现） vs /proc 扫描器
+ *
+ * 用法: php benchmarks/port_scan.php [--listen=6000] [--connected=3000] [--workers=8] [--rounds=5]
+ *
+ * 会 fork 若干子进程，共打开 listen 个监听 socket 和 connected 对已连接 socket
+ * （每对占两个 socket），模拟有上万 socket 的主机。仅支持 Linux。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use App\ProcSocketScanner;
+
+if (PHP_OS_FAMILY !== 'Linux') {
+    fwrite(STDERR, "此基准测试仅支持 Linux\n");
+    exit(1);
+}
+
+$options = getopt('', ['listen::', 'connected::', 'workers::', 'rounds::']);
+$listenCount = (int)($options['listen'] ?? 6000);
+$connectedCount = (int)($options['connected'] ?? 3000);
+$workers = max(1, (int)($options['workers'] ?? 8));
+$rounds = max(1, (int)($options['rounds'] ?? 5));
+
+if (!function_exists('pcntl_fork')) {
+    fwrite(STDERR, "需要 pcntl 扩展\n");
+    exit(1);
+}
+
+// 每个子进程都要打开上千个 fd，尽量把软限制调到硬限制
+if (function_exists('posix_getrlimit') && function_exists('posix_setrlimit')) {
+    $limits = posix_getrlimit();
+    $hard = $limits['hard openfiles'] ?? 'unlimited';
+    posix_setrlimit(POSIX_RLIMIT_NOFILE, $hard === 'unlimited' ? 1048576 : (int)$hard, $hard === 'unlimited' ? POSIX_RLIMIT_INFINITY : (int)$hard);
+}
+
+/**
+ * 子进程：打开分配到的 socket，把监听端口写回父进程后挂起
+ */
+function runWorker($pipe, int $listen, int $connected): void
+{
+    $servers = [];
+    $ports = [];
+    $held = [];
+    for ($i = 0; $i < max($listen, 1); $i++) {
+        $server = @stream_socket_server('tcp://127.0.0.1:0', $errno, $errstr);
+        if ($server === false) {
+            break;
+        }
+        $servers[] = $server;
+        $ports[] = (int)substr(strrchr(stream_socket_get_name($server, false), ':'), 1);
+    }
+    for ($i = 0; $i < $connected && !empty($servers); $i++) {
+        $server = $servers[$i % count($servers)];
+        $client = @stream_socket_client('tcp://127.0.0.1:' . $ports[$i % count($ports)], $errno, $errstr, 1);
+        if ($client === false) {
+            break;
+        }
+        $held[] = $client;
+        $held[] = stream_socket_accept($server, 1);
+    }
+    fwrite($pipe, json_encode(['ports' => $ports, 'connected' => count($held) / 2]) . "\n");
+    fclose($pipe);
+    while (true) {
+        sleep(60);
+    }
+}
+
+/**
+ * 旧实现：lsof -i :PORT，然后对每一行再执行一次 ps
+ */
+function legacyLsofQuery(string $port): array
+{
+    $output = [];
+    exec("lsof -i :{$port} -n -P 2>/dev/null", $output);
+    $processes = [];
+    foreach ($output as $i => $line) {
+        $line = trim($line);
+        if ($line === '' || ($i == 0 && strpos($line, 'COMMAND') !== false)) {
+            continue;
+        }
+        $parts = preg_split('/\s+/', $line);
+        if (count($parts) >= 5) {
+            $cmdOutput = [];
+            exec("ps -p {$parts[1]} -o command= 2>/dev/null", $cmdOutput);
+            $processes[] = ['pid' => $parts[1], 'name' => trim($cmdOutput[0] ?? $parts[0])];
+        }
+    }
+    return $processes;
+}
+
+function measure(callable $fn, int $rounds): array
+{
+    $times = [];
+    $rows = 0;
+    for ($i = 0; $i < $rounds; $i++) {
+        $start = hrtime(true);
+        $rows = count($fn());
+        $times[] = (hrtime(true) - $start) / 1e6;
+    }
+    sort($times);
+    return ['median' => $times[intdiv(count($times), 2)], 'min' => $times[0], 'rows' => $rows];
+}
+
+// 启动子进程
+$children = [];
+$ports = [];
+$connectedTotal = 0;
+for ($w = 0; $w < $workers; $w++) {
+    $pair = stream_socket_pair(STREAM_PF_UNIX, STREAM_SOCK_STREAM, STREAM_IPPROTO_IP);
+    $pid = pcntl_fork();
+    if ($pid === 0) {
+        fclose($pair[0]);
+        runWorker($pair[1], intdiv($listenCount, $workers), intdiv($connectedCount, $workers));
+        exit(0);
+    }
+    fclose($pair[1]);
+    $children[] = $pid;
+    $report = json_decode(fgets($pair[0]), true);
+    fclose($pair[0]);
+    $ports = array_merge($ports, $report['ports'] ?? []);
+    $connectedTotal += $report['connected'] ?? 0;
+}
+
+register_shutdown_function(function () use ($children) {
+    foreach ($children as $pid) {
+        posix_kill($pid, SIGKILL);
+        pcntl_waitpid($pid, $status);
+    }
+});
+
+$totalSockets = count($ports) + $connectedTotal * 2;
+printf("synthetic host: %d workers, %d listening, %d connected pairs (%d sockets)\n\n",
+    $workers, count($ports), $connectedTotal, $totalSockets);
+
+$scanner = new ProcSocketScanner();
+$hasLsof = trim((string)shell_exec('command -v lsof')) !== '';
+
+// 单端口：第一个 worker 的第一个监听端口（同时带有已连接 socket）
+$single = (string)$ports[0];
+// 多端口：50 个分散的监听端口，旧实现需要对每个端口各执行一次
+$multi = [];
+$step = max(1, intdiv(count($ports), 50));
+for ($i = 0; $i < count($ports) && count($multi) < 50; $i += $step) {
+    $multi[] = (string)$ports[$i];
+}
+
+$cases = [
+    'single port' => [
+        'legacy' => fn() => legacyLsofQuery($single),
+        'proc' => fn() => $scanner->scan(ProcSocketScanner::parsePortSpec($single)),
+    ],
+    '50 ports' => [
+        'legacy' => function () use ($multi) {
+            $rows = [];
+            foreach ($multi as $port) {
+                $rows = array_merge($rows, legacyLsofQuery($port));
+            }
+            return $rows;
+        },
+        'proc' => fn() => $scanner->scan(ProcSocketScanner::parsePortSpec(implode(',', $multi))),
+    ],
+    'port range' => [
+        'legacy' => fn() => legacyLsofQuery(min($ports) . '-' . max($ports)),
+        'proc' => fn() => $scanner->scan([[min($ports), max($ports)]]),
+    ],
+];
+
+printf("%-12s %-8s %12s %12s %8s\n", 'case', 'impl', 'median ms', 'min ms', 'rows');
+foreach ($cases as $name => $impls) {
+    foreach ($impls as $impl => $fn) {
+        if ($impl === 'legacy' && !$hasLsof) {
+            printf("%-12s %-8s %12s\n", $name, $impl, 'lsof n/a');
+            continue;
+        }
+        // 旧实现在大区间上每行 fork 一次 ps，非常慢，只跑一轮
+        $result = measure($fn, $impl === 'legacy' && $name === 'port range' ? 1 : $rounds);
+        printf("%-12s %-8s %12.2f %12.2f %8d\n", $name, $impl, $result['median'], $result['min'], $result['rows']);
+    }
+}
@@ -0,0 +1,75 @@
+<?php
+
+/**
+ * 进程监视基准测试：ps aux + 逐PID ps（旧实现） vs /proc 快照 + 增量 diff
+ *
+ * 用法: php benchmarks/process_monitor.php [--filter=php] [--rounds=10]
+ *
+ * 在本机当前进程集上测量每次刷新的耗时。仅支持 Linux。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use App\ProcessMonitor;
+
+if (PHP_OS_FAMILY !== 'Linux') {
+    fwrite(STDERR, "此基准测试仅支持 Linux\n");
+    exit(1);
+}
+
+$options = getopt('', ['filter::', 'rounds::']);
+$filter = (string)($options['filter'] ?? '');
+$rounds = max(2, (int)($options['rounds'] ?? 10));
+
+/**
+ * 旧实现：ps aux | grep NAME，然后对每一行再执行一次 ps
+ */
+function legacyPsQuery(string $name): array
+{
+    $output = [];
+    exec("ps aux | grep {$name} | grep -v grep 2>/dev/null", $output);
+    $processes = [];
+    foreach ($output as $line) {
+        $parts = preg_split('/\s+/', trim($line));
+        if (count($parts) >= 11) {
+            $cmdOutput = [];
+            exec("ps -p {$parts[1]} -o command= 2>/dev/null", $cmdOutput);
+            $processes[] = ['pid' => $parts[1], 'command' => trim($cmdOutput[0] ?? '')];
+        }
+    }
+    return $processes;
+}
+
+$monitor = new ProcessMonitor();
+$previous = $monitor->snapshot($filter);
+printf("processes matched: %d (filter: '%s')\n\n", count($previous), $filter);
+
+$snapshotTimes = [];
+$diffTimes = [];
+$changes = 0;
+for ($i = 0; $i < $rounds; $i++) {
+    usleep(100000);
+    $start = hrtime(true);
+    $current = $monitor->snapshot($filter);
+    $snapshotTimes[] = (hrtime(true) - $start) / 1e6;
+
+    $start = hrtime(true);
+    $ops = ProcessMonitor::diff($previous, $current);
+    $diffTimes[] = (hrtime(true) - $start) / 1e6;
+    $changes += count($ops);
+    $previous = $current;
+}
+sort($snapshotTimes);
+sort($diffTimes);
+
+printf("%-20s %12s %12s\n", 'step', 'median ms', 'max ms');
+printf("%-20s %12.2f %12.2f\n", 'proc snapshot', $snapshotTimes[intdiv($rounds, 2)], end($snapshotTimes));
+printf("%-20s %12.2f %12.2f\n", 'diff', $diffTimes[intdiv($rounds, 2)], end($diffTimes));
+printf("%-20s %12.1f\n", 'row ops / refresh', $changes / $rounds);
+
+// 旧实现需要名称过滤，且每行 fork 一次，只跑一轮
+if ($filter !== '') {
+    $start = hrtime(true);
+    $rows = legacyPsQuery($filter);
+    printf("%-20s %12.2f %12s (%d rows)\n", 'legacy ps query', (hrtime(true) - $start) / 1e6, '-', count($rows));
+}
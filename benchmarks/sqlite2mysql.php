@@ -0,0 +1,149 @@
+<?php
+
+/**
+ * SQLite 到 MySQL 转换吞吐量基准测试
+ *
+ * 用法: php benchmarks/sqlite2mysql.php [--rows=1000000] [--workers=4] [--batch-size=1000] [--keep]
+ *
+ * 生成一个包含多张表的 SQLite 文件，分别用整表读取（fetchAll）和游标流式转换导出到本地目录，
+ * 报告行/秒和峰值 RSS，不需要 MySQL 服务。每个场景在独立的子进程中运行，RSS 互不影响。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use App\MySQLDumpWriter;
+use App\SQLiteToMySQLConverter;
+
+$options = getopt('', ['rows::', 'workers::', 'batch-size::', 'keep', 'scenario:', 'sqlite:', 'dump:']);
+$batchSize = max(1, (int)($options['batch-size'] ?? 1000));
+
+/**
+ * 峰值 RSS（MB），包括已退出的子进程
+ */
+function peakRssMb(): float
+{
+    $self = getrusage(0)['ru_maxrss'];
+    $children = getrusage(1)['ru_maxrss'];
+    // Linux 单位为 KB，macOS 为字节
+    $divisor = PHP_OS_FAMILY === 'Darwin' ? 1048576 : 1024;
+    return max($self, $children) / $divisor;
+}
+
+// 子进程：运行单个场景，输出一行 JSON 结果
+if (isset($options['scenario'])) {
+    [$mode, $format, $workers] = explode(':', $options['scenario']);
+    $sqliteFile = $options['sqlite'];
+    $dumpDir = $options['dump'];
+    $start = microtime(true);
+    $rows = 0;
+
+    if ($mode === 'fetchall') {
+        // 对照组：整表读入内存后再写出
+        $converter = new SQLiteToMySQLConverter($sqliteFile, fn() => null);
+        $pdo = new PDO('sqlite:' . $sqliteFile);
+        $writer = new MySQLDumpWriter($dumpDir, $format);
+        foreach ($converter->inspect() as $table => $info) {
+            $all = $pdo->query('SELECT * FROM "' . $table . '"')->fetchAll(PDO::FETCH_NUM);
+            $writer->beginTable($table, $info['create'], $info['columns'], true);
+            foreach (array_chunk($all, $batchSize) as $chunk) {
+                $writer->writeRows($chunk);
+            }
+            $writer->endTable();
+            $rows += count($all);
+            unset($all);
+        }
+    } else {
+        $converter = new SQLiteToMySQLConverter(
+            $sqliteFile,
+            SQLiteToMySQLConverter::createWriterFactory($dumpDir, $format, $batchSize),
+            ['batchSize' => $batchSize, 'workers' => (int)$workers, 'dropExisting' => true]
+        );
+        $converter->onEvent(function (array $event) use (&$rows) {
+            if ($event['type'] === 'done') {
+                $rows = $event['done'];
+            }
+        });
+        $converter->run();
+    }
+
+    $bytes = 0;
+    foreach (glob($dumpDir . '/*') as $file) {
+        $bytes += filesize($file);
+    }
+    echo json_encode([
+        'rows' => $rows,
+        'seconds' => microtime(true) - $start,
+        'rss' => peakRssMb(),
+        'bytes' => $bytes,
+    ]), "\n";
+    exit(0);
+}
+
+if (!extension_loaded('pdo_sqlite')) {
+    fwrite(STDERR, "需要 pdo_sqlite 扩展\n");
+    exit(1);
+}
+
+$rowCount = max(4, (int)($options['rows'] ?? 1000000));
+$workers = max(1, (int)($options['workers'] ?? 4));
+$workDir = sys_get_temp_dir() . '/sqlite2mysql-bench-' . getmypid();
+mkdir($workDir);
+$sqliteFile = $workDir . '/source.db';
+
+// 生成测试数据：4 张表，行数 4:3:2:1
+$start = microtime(true);
+$pdo = new PDO('sqlite:' . $sqliteFile);
+$pdo->setAttribute(PDO::ATTR_ERRMODE, PDO::ERRMODE_EXCEPTION);
+$pdo->exec('PRAGMA journal_mode = OFF');
+$pdo->exec('PRAGMA synchronous = OFF');
+$shares = ['orders' => 4, 'events' => 3, 'users' => 2, 'notes' => 1];
+foreach ($shares as $table => $share) {
+    $pdo->exec("CREATE TABLE $table (id INTEGER PRIMARY KEY, name VARCHAR(64) NOT NULL, score REAL, payload BLOB, note TEXT, created DATETIME)");
+    $insert = $pdo->prepare("INSERT INTO $table VALUES (?, ?, ?, ?, ?, ?)");
+    $count = intdiv($rowCount * $share, array_sum($shares));
+    $pdo->beginTransaction();
+    for ($i = 1; $i <= $count; $i++) {
+        $insert->execute([
+            $i,
+            "name-$i",
+            $i % 7 === 0 ? null : $i / 3,
+            random_bytes(16),
+            $i % 5 === 0 ? "line1\nline2\t'quoted' \\ $i" : "note $i",
+            date('Y-m-d H:i:s', 1700000000 + $i),
+        ]);
+    }
+    $pdo->commit();
+}
+$pdo = null;
+printf("generated %d rows in %.1f s (%.1f MB sqlite file)\n\n", $rowCount, microtime(true) - $start, filesize($sqliteFile) / 1048576);
+
+$scenarios = [
+    'fetchAll, sql' => 'fetchall:sql:1',
+    'stream, sql, 1 worker' => 'stream:sql:1',
+    "stream, sql, $workers workers" => "stream:sql:$workers",
+    'stream, tsv, 1 worker' => 'stream:tsv:1',
+    "stream, tsv, $workers workers" => "stream:tsv:$workers",
+];
+
+printf("%-26s %12s %10s %14s %10s\n", 'scenario', 'rows/sec', 'seconds', 'peak RSS (MB)', 'dump MB');
+foreach ($scenarios as $label => $scenario) {
+    $dumpDir = $workDir . '/' . str_replace(':', '-', $scenario);
+    $command = escapeshellarg(PHP_BINARY) . ' ' . escapeshellarg(__FILE__)
+        . ' --scenario=' . $scenario
+        . ' --sqlite=' . escapeshellarg($sqliteFile)
+        . ' --dump=' . escapeshellarg($dumpDir)
+        . ' --batch-size=' . $batchSize;
+    $result = json_decode((string)shell_exec($command), true);
+    if (!is_array($result)) {
+        printf("%-26s %12s\n", $label, 'failed');
+        continue;
+    }
+    printf("%-26s %12d %10.2f %14.1f %10.1f\n", $label, $result['rows'] / max(0.001, $result['seconds']),
+        $result['seconds'], $result['rss'], $result['bytes'] / 1048576);
+}
+
+if (isset($options['keep'])) {
+    echo "\noutput kept in $workDir\n";
+} else {
+    exec('rm -rf ' . escapeshellarg($workDir));
+}
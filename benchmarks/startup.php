@@ -0,0 +1,129 @@
+<?php
+
+/**
+ * 启动耗时基准测试：FFI 加载方式、立即创建 vs 延迟创建标签页
+ *
+ * 用法: php benchmarks/startup.php [--rounds=5] [--skip-gui]
+ *
+ * 第一部分在子进程中分别用 FFI::cdef（原始头文件）、FFI::load（预处理头文件）和 ffi.preload
+ * 加载 libui 定义，报告加载耗时；第二部分运行 cli.php gui --startup-probe，
+ * 报告从进程启动到第一帧显示的耗时和峰值内存。第二部分需要图形环境。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use Kingbes\Libui\Base;
+
+$options = getopt('', ['rounds::', 'skip-gui', 'scenario:']);
+$rounds = max(1, (int)($options['rounds'] ?? 5));
+
+// 子进程：用指定方式加载 FFI 定义，输出一行 JSON 结果
+if (isset($options['scenario'])) {
+    $start = microtime(true);
+    switch ($options['scenario']) {
+        case 'cdef':
+            $libPath = (new ReflectionMethod(Base::class, 'getLibFilePath'))->invoke(null);
+            FFI::cdef(file_get_contents(dirname((new ReflectionClass(Base::class))->getFileName()) . '/Libui.h'), $libPath);
+            break;
+        case 'load':
+            FFI::load(Base::getScopedHeaderPath());
+            break;
+        case 'preload':
+            FFI::scope(Base::FFI_SCOPE);
+            break;
+    }
+    echo json_encode([
+        'ffi_ms' => (microtime(true) - $start) * 1000,
+        'script_ms' => (microtime(true) - $_SERVER['REQUEST_TIME_FLOAT']) * 1000,
+    ]), "\n";
+    exit(0);
+}
+
+/**
+ * 运行命令直到输出第一行，返回 [墙钟耗时（毫秒）, 解析后的 JSON]
+ */
+function runUntilFirstLine(string $command): array
+{
+    $start = microtime(true);
+    $process = proc_open($command, [1 => ['pipe', 'w'], 2 => ['file', PHP_OS_FAMILY === 'Windows' ? 'NUL' : '/dev/null', 'w']], $pipes);
+    if (!is_resource($process)) {
+        return [0.0, null];
+    }
+    $line = fgets($pipes[1]);
+    $elapsed = (microtime(true) - $start) * 1000;
+    fclose($pipes[1]);
+    proc_close($process);
+    return [$elapsed, $line === false ? null : json_decode($line, true)];
+}
+
+function median(array $values): float
+{
+    if (empty($values)) {
+        return 0.0;
+    }
+    sort($values);
+    $middle = intdiv(count($values), 2);
+    return count($values) % 2 ? $values[$middle] : ($values[$middle - 1] + $values[$middle]) / 2;
+}
+
+$php = escapeshellarg(PHP_BINARY);
+$header = Base::getScopedHeaderPath();
+if (!is_file($header)) {
+    Base::writeScopedHeader();
+}
+$preload = '-d ffi.enable=preload -d ffi.preload=' . escapeshellarg($header);
+
+echo "FFI definitions (median of $rounds runs)\n";
+printf("%-10s %12s %16s %16s\n", 'mode', 'ffi ms', 'script ms', 'process ms');
+foreach (['cdef' => '', 'load' => '', 'preload' => $preload] as $scenario => $flags) {
+    $ffi = $script = $wall = [];
+    for ($i = 0; $i < $rounds; $i++) {
+        [$elapsed, $result] = runUntilFirstLine("$php $flags " . escapeshellarg(__FILE__) . " --scenario=$scenario");
+        if (!is_array($result)) {
+            continue;
+        }
+        $ffi[] = $result['ffi_ms'];
+        $script[] = $result['script_ms'];
+        $wall[] = $elapsed;
+    }
+    if (empty($wall)) {
+        printf("%-10s %12s\n", $scenario, 'failed');
+        continue;
+    }
+    printf("%-10s %12.2f %16.2f %16.2f\n", $scenario, median($ffi), median($script), median($wall));
+}
+
+if (isset($options['skip-gui'])) {
+    exit(0);
+}
+if (PHP_OS_FAMILY === 'Linux' && !getenv('DISPLAY') && !getenv('WAYLAND_DISPLAY')) {
+    echo "\nno display available, skipping GUI startup (run under xvfb-run to include it)\n";
+    exit(0);
+}
+
+$cli = escapeshellarg(dirname(__DIR__) . '/cli.php');
+$scenarios = [
+    'eager tabs' => "$php $cli gui --eager --startup-probe",
+    'lazy tabs' => "$php $cli gui --startup-probe",
+    'lazy tabs + preload' => "$php $preload $cli gui --startup-probe",
+];
+
+echo "\nGUI startup to first frame (median of $rounds runs)\n";
+printf("%-22s %12s %16s %14s\n", 'mode', 'process ms', 'PHP heap MB', 'peak RSS MB');
+foreach ($scenarios as $label => $command) {
+    $wall = $heap = $rss = [];
+    for ($i = 0; $i < $rounds; $i++) {
+        [$elapsed, $result] = runUntilFirstLine($command);
+        if (!is_array($result)) {
+            continue;
+        }
+        $wall[] = $elapsed;
+        $heap[] = $result['peak_memory_mb'];
+        $rss[] = $result['peak_rss_mb'];
+    }
+    if (empty($wall)) {
+        printf("%-22s %12s\n", $label, 'failed');
+        continue;
+    }
+    printf("%-22s %12.1f %16.1f %14.1f\n", $label, median($wall), median($heap), median($rss));
+}
@@ -0,0 +1,131 @@
+<?php
+
+/**
+ * 表格单元格基准测试：旧 CellValue 回调 vs 列式数据源
+ *
+ * 用法: php benchmarks/table_cells.php [--rows=100000] [--columns=10] [--frames=50]
+ *
+ * 不需要显示器：直接调用 CellValue 回调模拟滚动时每帧 10k 个可见单元格的绘制，
+ * 并统计 setData 在只修改一行时发出的行变化通知数。需要能加载 libui 动态库。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use Kingbes\Libui\Table;
+use Kingbes\Libui\SDK\ColumnarTableData;
+use Kingbes\Libui\SDK\LazyTableDataSource;
+use Kingbes\Libui\SDK\LibuiTable;
+
+$options = getopt('', ['rows::', 'columns::', 'frames::']);
+$rowCount = (int)($options['rows'] ?? 100000);
+$columnCount = max(2, (int)($options['columns'] ?? 10));
+$frames = max(1, (int)($options['frames'] ?? 50));
+$visibleRows = intdiv(10000, $columnCount);
+
+try {
+    Table::ffi();
+} catch (\Throwable $e) {
+    fwrite(STDERR, "无法加载 libui: " . $e->getMessage() . "\n");
+    exit(1);
+}
+
+function makeRow(int $i, int $columns): array
+{
+    $row = [$i % 2];
+    for ($c = 1; $c < $columns; $c++) {
+        $row[] = "r{$i}c{$c}";
+    }
+    return $row;
+}
+
+$data = [];
+for ($i = 0; $i < $rowCount; $i++) {
+    $data[] = makeRow($i, $columnCount);
+}
+$columnTypes = [0 => 'checkbox'];
+for ($c = 1; $c < $columnCount; $c++) {
+    $columnTypes[$c] = 'text';
+}
+
+/**
+ * 旧实现的 CellValue 回调（每个单元格多次 isset 判断列类型）
+ */
+$legacyCellValue = function ($row, $column) use (&$data, $columnTypes) {
+    if (!isset($data[$row][$column])) {
+        if (isset($columnTypes[$column]) && $columnTypes[$column] === 'checkbox') {
+            return Table::createValueInt(0);
+        } else {
+            return Table::createValueStr('');
+        }
+    }
+    if (isset($columnTypes[$column]) && $columnTypes[$column] === 'checkbox') {
+        $value = $data[$row][$column] ?? 0;
+        return Table::createValueInt((int)$value);
+    } else {
+        $value = $data[$row][$column] ?? '';
+        return Table::createValueStr((string)$value);
+    }
+};
+
+$table = new LibuiTable();
+$table->addCheckboxColumn("选择", 0, -1);
+for ($c = 1; $c < $columnCount; $c++) {
+    $table->addTextColumn("C{$c}", $c);
+}
+$table->setData($data);
+
+/**
+ * 模拟滚动：每帧从随机位置开始绘制 $visibleRows 行
+ */
+function paintFrames(callable $cellValue, int $frames, int $visibleRows, int $rowCount, int $columnCount): float
+{
+    mt_srand(42);
+    $start = hrtime(true);
+    for ($f = 0; $f < $frames; $f++) {
+        $top = mt_rand(0, max(0, $rowCount - $visibleRows));
+        for ($r = $top; $r < $top + $visibleRows; $r++) {
+            for ($c = 0; $c < $columnCount; $c++) {
+                // libui 使用后会释放返回值
+                Table::freeValue($cellValue($r, $c));
+            }
+        }
+    }
+    return (hrtime(true) - $start) / 1e6 / $frames;
+}
+
+printf("%d rows x %d columns, %d visible cells per frame, %d frames\n\n", $rowCount, $columnCount, $visibleRows * $columnCount, $frames);
+printf("%-28s %14s\n", 'paint', 'ms / 10k cells');
+printf("%-28s %14.2f\n", 'legacy callback', paintFrames($legacyCellValue, $frames, $visibleRows, $rowCount, $columnCount));
+printf("%-28s %14.2f\n", 'columnar store', paintFrames([$table, 'cellValue'], $frames, $visibleRows, $rowCount, $columnCount));
+
+// 1M 行按需加载，只有绘制到的页会调用 provider
+$providerCalls = 0;
+$lazy = new LazyTableDataSource(1000000, function ($offset, $limit) use (&$providerCalls, $columnCount) {
+    $providerCalls++;
+    $rows = [];
+    for ($i = $offset; $i < $offset + $limit; $i++) {
+        $rows[] = makeRow($i, $columnCount);
+    }
+    return $rows;
+});
+$lazyTable = new LibuiTable();
+$lazyTable->addCheckboxColumn("选择", 0, -1);
+for ($c = 1; $c < $columnCount; $c++) {
+    $lazyTable->addTextColumn("C{$c}", $c);
+}
+$lazyTable->setDataSource($lazy);
+$memoryBefore = memory_get_usage();
+printf("%-28s %14.2f (%d page loads, +%.1f MB)\n", 'lazy source, 1M rows',
+    paintFrames([$lazyTable, 'cellValue'], $frames, $visibleRows, 1000000, $columnCount),
+    $providerCalls, (memory_get_usage() - $memoryBefore) / 1048576);
+
+// setData 只改一行时的行通知数
+$updated = $data;
+$updated[intdiv($rowCount, 2)][1] = 'changed';
+$store = new ColumnarTableData($data);
+$start = hrtime(true);
+$changed = $store->setRows($updated);
+$diffMs = (hrtime(true) - $start) / 1e6;
+printf("\n%-28s %14s %14s\n", 'setData (1 row changed)', 'row notices', 'ms');
+printf("%-28s %14d %14s\n", 'legacy', $rowCount, '-');
+printf("%-28s %14d %14.2f\n", 'diff', count($changed), $diffMs);
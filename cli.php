@@ -21,7 +21,7 @@ try {
     switch ($command) {
         case 'gui':
             // Run the GUI application
-            runGuiApplication();
+            runGuiApplication(in_array('--eager', $args, true), in_array('--startup-probe', $args, true), getProfileThreshold($args));
             break;
 
         case 'build':
@@ -41,55 +41,87 @@ try {
 
 /**
  * Run the GUI application
+ *
+ * @param bool $eager Build every tab before the window appears instead of on first selection
+ * @param bool $probe Print startup time and peak memory after the first frame, then quit
+ * @param float|null $profileThresholdMs Enable the callback profiler and flag callbacks slower than this
  */
-function runGuiApplication()
+function runGuiApplication(bool $eager = false, bool $probe = false, ?float $profileThresholdMs = null)
 {
+    // Only callbacks registered after this point are timed, so enable before any UI is created
+    $profiler = null;
+    if ($profileThresholdMs !== null) {
+        $profiler = Kingbes\Libui\SDK\LibuiApplication::getInstance()->enableProfiler($profileThresholdMs);
+    }
+
     // Initialize the GUI application
     global $application;
     $application = new App\App();
 
-    // Create port killer tool
-    $portKiller = new App\PortKiller();
-    $application->addTab("端口查杀", $portKiller->getControl());
-
-    // Create process killer tool
-    $processKiller = new App\ProcessKiller();
-    $application->addTab("进程查杀", $processKiller->getControl());
-
-    // Create download accelerator tab
-    $downloadAcceleratorTab = new App\DownloadAcceleratorTab();
-    $application->addTab("下载加速", $downloadAcceleratorTab->getControl());
-
-    // Create SQLite2MySQL tab
-    $sqlite2MysqlTab = new App\SQLite2MySQLTab();
-    $application->addTab("SQLite转MySQL", $sqlite2MysqlTab->getControl());
-
-    // Create intelligent packager tab
-    $intelligentPackagerTab = new App\IntelligentPackagerTab();
-    $application->addTab("智能打包工具", $intelligentPackagerTab->getControl());
-
-    // Create test step tab
-    $testStepTab = new App\TestStepTab();
-    $application->addTab("测试步骤切换", $testStepTab->getBox());
-
-    // Create wifi tab
-//    $wifiTab = new App\WifiTab();
-//    $application->addTab("Wifi破解", $wifiTab->getControl());
-
-    // Create PHP-FPM calculator tab
-    $phpFpmCalculatorTab = new App\PHPFpmCalculatorTab();
-    $application->addTab("PHP-FPM计算器", $phpFpmCalculatorTab->getControl());
+    // Tab name => [class, method returning the control]
+    $tabs = [
+        "端口查杀" => [App\PortKiller::class, 'getControl'],
+        "进程查杀" => [App\ProcessKiller::class, 'getControl'],
+        "下载加速" => [App\DownloadAcceleratorTab::class, 'getControl'],
+        "SQLite转MySQL" => [App\SQLite2MySQLTab::class, 'getControl'],
+        "智能打包工具" => [App\IntelligentPackagerTab::class, 'getControl'],
+        "测试步骤切换" => [App\TestStepTab::class, 'getBox'],
+//        "Wifi破解" => [App\WifiTab::class, 'getControl'],
+        "PHP-FPM计算器" => [App\PHPFpmCalculatorTab::class, 'getControl'],
+        "示例" => [App\ExampleTab::class, 'getControl'],
+        "示例2" => [App\DatetimeTab::class, 'getControl'],
+    ];
+    if ($profiler !== null) {
+        $tabs["性能"] = [App\PerformanceTab::class, 'getControl'];
+    }
 
-    // Create example tab
-    $exampleTab = new App\ExampleTab();
-    $application->addTab("示例", $exampleTab->getControl());
+    // Tabs are built when first selected; keep instances alive when building eagerly
+    $instances = [];
+    foreach ($tabs as $name => [$class, $method]) {
+        if ($eager) {
+            $instances[$name] = new $class();
+            $application->addTab($name, $instances[$name]->$method());
+        } else {
+            $application->addLazyTab($name, $class, $method);
+        }
+    }
 
-    // Create datetime tab
-    $exampleTab2 = new App\DatetimeTab();
-    $application->addTab("示例2", $exampleTab2->getControl());
+    if ($probe) {
+        // Idle callbacks run after the pending redraws, i.e. once the first frame is on screen
+        Kingbes\Libui\SDK\LibuiApplication::getInstance()->queueMain(function () {
+            echo json_encode([
+                'startup_ms' => (microtime(true) - $_SERVER['REQUEST_TIME_FLOAT']) * 1000,
+                'peak_memory_mb' => memory_get_peak_usage(true) / 1048576,
+                // ru_maxrss is in KB on Linux and bytes on macOS
+                'peak_rss_mb' => (getrusage()['ru_maxrss'] ?? 0) / (PHP_OS_FAMILY === 'Darwin' ? 1048576 : 1024),
+            ]), PHP_EOL;
+            Kingbes\Libui\SDK\LibuiApplication::getInstance()->quit();
+        });
+    }
 
     // Run the application
     $application->run();
+
+    if ($profiler !== null) {
+        $file = $profiler->exportChromeTrace(sys_get_temp_dir() . DIRECTORY_SEPARATOR . 'php-tools-trace.json');
+        echo "Chrome trace written to $file" . PHP_EOL;
+    }
+}
+
+/**
+ * Threshold in ms from --profile or --profile=<ms>, null when profiling is off
+ */
+function getProfileThreshold(array $args): ?float
+{
+    foreach ($args as $arg) {
+        if ($arg === '--profile') {
+            return 16.0;
+        }
+        if (str_starts_with($arg, '--profile=')) {
+            return max(0.1, (float)substr($arg, strlen('--profile=')));
+        }
+    }
+    return null;
 }
 
 /**
@@ -130,6 +162,10 @@ function showHelp()
     echo "Usage: php cli.php [command]\n\n";
     echo "Available commands:\n";
     echo "  gui     Start the GUI application\n";
+    echo "          --eager          build every tab at startup instead of on first selection\n";
+    echo "          --startup-probe  print startup time and peak memory after the first frame, then exit\n";
+    echo "          --profile[=ms]   time main-thread callbacks, add a Performance tab and write a Chrome trace on exit\n";
+    echo "                           (callbacks slower than ms, default 16, are flagged)\n";
     echo "  build   Build the PHAR file\n";
     echo "  help    Show this help message\n";
     echo "\n";
@@ -7,26 +7,122 @@ namespace Kingbes\Libui;
 
 abstract class Base
 {
+    // ffi.preload 使用的作用域名称
+    public const FFI_SCOPE = 'LIBUI';
+
     // private \FFI $ffi;
     private static \FFI $ffi;
 
+    // ffi() 被调用的次数，近似等于 FFI 调用次数，只在性能分析开启时计数
+    private static int $calls = 0;
+    private static bool $counting = false;
+
     /**
      * 获取 FFI 实例
      *
+     * 依次尝试：ffi.preload 预加载的作用域（不需要再解析头文件）、
+     * 安装时生成的预处理头文件（FFI::load）、原始头文件（FFI::cdef）。
+     *
      * @return \FFI
      * @throws RuntimeException Missing libui dependencies.
      */
     public static function ffi(): \FFI
     {
+        if (self::$counting) {
+            self::$calls++;
+        }
         if (!isset(self::$ffi)) {
-            $headerPath = __DIR__ . '/Libui.h';
-            $dllPath = self::getLibFilePath();
-            $libHeader = file_get_contents($headerPath);
-            self::$ffi = \FFI::cdef($libHeader, $dllPath);
+            self::$ffi = self::loadFfi();
         }
         return self::$ffi;
     }
 
+    /**
+     * 累计的 FFI 调用次数：ffi() 的调用加上 addCall() 记录的调用
+     */
+    public static function getCallCount(): int
+    {
+        return self::$calls;
+    }
+
+    /**
+     * 开启或关闭调用计数（由性能分析器控制）
+     */
+    public static function setCallCounting(bool $counting): void
+    {
+        self::$counting = $counting;
+    }
+
+    public static function isCallCounting(): bool
+    {
+        return self::$counting;
+    }
+
+    /**
+     * 记录一次不经过 ffi() 的调用（缓存了 FFI 实例的调用方在开启计数时使用）
+     */
+    public static function addCall(): void
+    {
+        self::$calls++;
+    }
+
+    /**
+     * 预处理头文件路径，可用于 php -d ffi.preload=<路径>
+     */
+    public static function getScopedHeaderPath(): string
+    {
+        return __DIR__ . '/Libui.ffi.h';
+    }
+
+    /**
+     * 生成预处理头文件：去掉注释和空行，并通过 FFI_SCOPE/FFI_LIB 指定作用域和库路径
+     *
+     * 由 scripts/patchBase.php 在 composer install/update 后调用。
+     *
+     * @return string 生成的文件路径
+     */
+    public static function writeScopedHeader(): string
+    {
+        $header = file_get_contents(__DIR__ . '/Libui.h');
+        $header = preg_replace('~/\*.*?\*/~s', '', $header);
+        $header = preg_replace('~//[^\n]*~', '', $header);
+        $header = preg_replace('~\n\s*\n~', "\n", $header);
+
+        $content = '#define FFI_SCOPE "' . self::FFI_SCOPE . "\"\n"
+            . '#define FFI_LIB "' . str_replace('\\', '/', self::getLibFilePath()) . "\"\n"
+            . trim($header) . "\n";
+
+        $path = self::getScopedHeaderPath();
+        file_put_contents($path, $content);
+        return $path;
+    }
+
+    private static function loadFfi(): \FFI
+    {
+        if (ini_get('ffi.preload')) {
+            try {
+                return \FFI::scope(self::FFI_SCOPE);
+            } catch (\FFI\Exception $e) {
+                // 预加载的不是 libui，继续尝试其他方式
+            }
+        }
+
+        // 头文件比预处理文件新时说明预处理文件已过期；库路径变化（如项目被移动）时 FFI::load 会失败
+        $scoped = self::getScopedHeaderPath();
+        if (is_file($scoped) && filemtime($scoped) >= filemtime(__DIR__ . '/Libui.h')) {
+            try {
+                $ffi = \FFI::load($scoped);
+                if ($ffi !== null) {
+                    return $ffi;
+                }
+            } catch (\FFI\Exception $e) {
+                // 回退到解析原始头文件
+            }
+        }
+
+        return \FFI::cdef(file_get_contents(__DIR__ . '/Libui.h'), self::getLibFilePath());
+    }
+
     /**
      * 获取 libui 库文件的路径
      *
@@ -13,6 +13,10 @@ exec('vendor\\bin\\pest tests\\Feature --testdox', $featureOutput, $featureRetur
 echo "正在运行架构测试...\n";  
 exec('vendor\\bin\\pest tests\\Arch --testdox', $archOutput, $archReturn);
 
+// 基准测试不需要图形环境，结果输出在 stderr
+echo "正在运行基准测试...\n";
+exec('vendor\\bin\\pest --testsuite=Benchmark --testdox 2>&1', $benchmarkOutput, $benchmarkReturn);
+
 // 显示结果
 echo "\n=== 单元测试结果 ===\n";
 echo implode("\n", $unitOutput) . "\n";
@@ -23,12 +27,16 @@ echo implode("\n", $featureOutput) . "\n";
 echo "\n=== 架构测试结果 ===\n";
 echo implode("\n", $archOutput) . "\n";
 
+echo "\n=== 基准测试结果 ===\n";
+echo implode("\n", $benchmarkOutput) . "\n";
+
 // 总体结果
-$allPassed = ($unitReturn === 0 && $featureReturn === 0 && $archReturn === 0);
+$allPassed = ($unitReturn === 0 && $featureReturn === 0 && $archReturn === 0 && $benchmarkReturn === 0);
 echo "\n=== 总体结果 ===\n";
 echo $allPassed ? "✅ 所有测试通过!" : "❌ 部分测试失败";
 echo "\n单元测试: " . ($unitReturn === 0 ? "✅ 通过" : "❌ 失败") . "\n";
 echo "功能测试: " . ($featureReturn === 0 ? "✅ 通过" : "❌ 失败") . "\n";
 echo "架构测试: " . ($archReturn === 0 ? "✅ 通过" : "❌ 失败") . "\n";
+echo "基准测试: " . ($benchmarkReturn === 0 ? "✅ 通过" : "❌ 失败") . "\n";
 
 echo "\n测试完成!\n";
\ No newline at end of file
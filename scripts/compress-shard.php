@@ -0,0 +1,33 @@
+#!/usr/bin/env php
+<?php
+
+/**
+ * 增量 ZIP 打包的压缩工作进程（由 IncrementalBuilder 启动）
+ *
+ * 用法: php scripts/compress-shard.php BASE
+ *
+ * 读取 BASE.list 中序列化的 条目名 => 文件路径，压缩数据写入 BASE.bin，完成后写入索引 BASE.idx。
+ */
+
+require_once __DIR__ . '/../vendor/autoload.php';
+
+use App\IncrementalBuilder;
+
+$base = $argv[1] ?? '';
+if ($base === '') {
+    fwrite(STDERR, "用法: php scripts/compress-shard.php BASE\n");
+    exit(2);
+}
+
+$files = @unserialize((string)@file_get_contents($base . '.list'));
+if (!is_array($files)) {
+    fwrite(STDERR, "无法读取文件列表: $base.list\n");
+    exit(1);
+}
+
+try {
+    IncrementalBuilder::compressShard($files, $base);
+} catch (\Throwable $e) {
+    fwrite(STDERR, $e->getMessage() . "\n");
+    exit(1);
+}
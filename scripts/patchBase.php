@@ -6,13 +6,19 @@ if (!file_exists($checkFile)) {
     exit(0);
 }
 
-$file = file_get_contents($checkFile);
-if(str_contains($file, 'getLibFilePath')){
-    echo "Base 已修复\n";
-    exit(0);
+// 用项目中修改过的 Base（PHAR 中的库路径、FFI 快速加载）覆盖 vendor 中的版本
+$patchedFile = __DIR__ . '/../kingbes/libui/src/Base.php';
+if (file_get_contents($checkFile) !== file_get_contents($patchedFile)) {
+    copy($patchedFile, $checkFile);
 }
-
-file_put_contents($checkFile, file_get_contents(__DIR__ . '../kingbes/libui/patchBase.php'), FILE_APPEND);
-
 echo "Base 已修复\n";
-    exit(0);
\ No newline at end of file
+
+// 生成预处理头文件，启动时用 FFI::load 加载，也可以用于 ffi.preload
+require_once $checkFile;
+try {
+    $header = Kingbes\Libui\Base::writeScopedHeader();
+    echo "已生成 FFI 头文件: $header\n";
+} catch (\Throwable $e) {
+    echo "生成 FFI 头文件失败: " . $e->getMessage() . "\n";
+}
+exit(0);
@@ -0,0 +1,171 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 列式表格数据
+ *
+ * 每一列的值存放在一个连续的 packed 数组中，列类型在写入时统一转换，
+ * 绘制时无需再做类型判断和转换。setRows() 会返回真正发生变化的行号，
+ * 供 LibuiTable 只通知这些行。
+ */
+class ColumnarTableData implements LibuiTableDataSource
+{
+    public const TYPE_STRING = 'string';
+    public const TYPE_INT = 'int';
+
+    private array $columns = []; // 列号 => 该列所有行的值
+    private array $types = [];   // 列号 => 列类型
+    private int $rowCount = 0;
+
+    public function __construct(array $rows = []) {
+        if (!empty($rows)) {
+            $this->setRows($rows);
+        }
+    }
+
+    /**
+     * 声明列类型，已有数据会按新类型转换
+     */
+    public function setColumnType(int $column, string $type): self {
+        $this->types[$column] = $type;
+        if (isset($this->columns[$column])) {
+            foreach ($this->columns[$column] as $row => $value) {
+                $this->columns[$column][$row] = $this->coerce($type, $value);
+            }
+        }
+        return $this;
+    }
+
+    public function getRowCount(): int {
+        return $this->rowCount;
+    }
+
+    public function getColumnCount(): int {
+        return empty($this->columns) ? 0 : max(array_keys($this->columns)) + 1;
+    }
+
+    public function getCell(int $row, int $column): mixed {
+        return $this->columns[$column][$row] ?? null;
+    }
+
+    public function setCell(int $row, int $column, mixed $value): void {
+        if ($row < 0 || $row >= $this->rowCount) {
+            return;
+        }
+        $this->ensureColumn($column);
+        $this->columns[$column][$row] = $this->coerce($this->types[$column] ?? null, $value);
+    }
+
+    public function getRow(int $row): array {
+        $values = [];
+        foreach ($this->columns as $column => $cells) {
+            $values[$column] = $cells[$row] ?? null;
+        }
+        return $values;
+    }
+
+    /**
+     * 整体替换数据
+     *
+     * @return int[] 新旧数据都存在且内容发生变化的行号（升序）
+     */
+    public function setRows(array $rows): array {
+        $rows = array_values($rows);
+        $count = count($rows);
+
+        // 按行写入新的列数组
+        $width = $this->getColumnCount();
+        foreach ($rows as $row) {
+            $width = max($width, count($row));
+        }
+        $columns = [];
+        for ($column = 0; $column < $width; $column++) {
+            $columns[$column] = $count > 0 ? array_fill(0, $count, null) : [];
+        }
+        foreach ($rows as $index => $row) {
+            foreach ($row as $column => $value) {
+                $columns[$column][$index] = $this->coerce($this->types[$column] ?? null, $value);
+            }
+        }
+
+        // 逐列比较公共部分
+        $common = min($count, $this->rowCount);
+        $changed = [];
+        foreach ($columns as $column => $cells) {
+            $old = $this->columns[$column] ?? [];
+            for ($i = 0; $i < $common; $i++) {
+                if (($old[$i] ?? null) !== $cells[$i]) {
+                    $changed[$i] = true;
+                }
+            }
+        }
+        ksort($changed);
+
+        $this->columns = $columns;
+        $this->rowCount = $count;
+
+        return array_keys($changed);
+    }
+
+    public function insertRow(int $index, array $row): void {
+        $index = max(0, min($index, $this->rowCount));
+        $width = max($this->getColumnCount(), count($row));
+        for ($column = 0; $column < $width; $column++) {
+            $this->ensureColumn($column);
+            $value = $this->coerce($this->types[$column] ?? null, $row[$column] ?? null);
+            array_splice($this->columns[$column], $index, 0, [$value]);
+        }
+        $this->rowCount++;
+    }
+
+    /**
+     * 更新一行
+     *
+     * @return bool 内容是否发生变化
+     */
+    public function updateRow(int $index, array $row): bool {
+        if ($index < 0 || $index >= $this->rowCount) {
+            return false;
+        }
+        $changed = false;
+        foreach ($row as $column => $value) {
+            $this->ensureColumn($column);
+            $value = $this->coerce($this->types[$column] ?? null, $value);
+            if ($this->columns[$column][$index] !== $value) {
+                $this->columns[$column][$index] = $value;
+                $changed = true;
+            }
+        }
+        return $changed;
+    }
+
+    public function removeRow(int $index): void {
+        if ($index < 0 || $index >= $this->rowCount) {
+            return;
+        }
+        foreach ($this->columns as $column => $cells) {
+            array_splice($this->columns[$column], $index, 1);
+        }
+        $this->rowCount--;
+    }
+
+    /**
+     * 新列补齐到当前行数，保持 packed 数组
+     */
+    private function ensureColumn(int $column): void {
+        for ($i = $this->getColumnCount(); $i <= $column; $i++) {
+            $this->columns[$i] = $this->rowCount > 0 ? array_fill(0, $this->rowCount, null) : [];
+        }
+    }
+
+    private function coerce(?string $type, mixed $value): mixed {
+        if ($type === self::TYPE_INT) {
+            return (int)$value;
+        }
+        if ($type === self::TYPE_STRING) {
+            return (string)$value;
+        }
+        return $value;
+    }
+}
@@ -7,11 +7,22 @@ use Psr\Log\NullLogger;
 
 /**
  * 统一事件管理器
+ *
+ * 每个事件的监听器在订阅变化后编译为按优先级排好序的扁平列表，emit 时直接遍历。
+ * 高频事件（滑块拖动、批量勾选等）可以用以下方式订阅：
+ * - onCoalesced：同一轮主循环中多次触发只在 uiQueueMain 回调中处理最后一次
+ * - onDebounced：停止触发指定毫秒后处理最后一次
+ * - onThrottled：每隔指定毫秒最多处理一次，最后一次不会丢失
  */
 class EventManager
 {
-    private array $listeners = [];
+    private array $listeners = []; // 事件 => 监听器 ID => [优先级, 注册序号, 回调]
+    private array $compiled = [];  // 事件 => 排好序的回调列表
+    private int $nextId = 0;
     private ?LoggerInterface $logger = null;
+    private bool $debug = false;
+    private $queueMain = null;
+    private $timer = null;
 
     public function __construct() {
         // 延迟初始化 Logger，避免循环依赖
@@ -29,53 +40,217 @@ class EventManager
         return $this->logger;
     }
 
+    /**
+     * 设置 Logger，非空 Logger 时记录订阅和每次 emit 的调试日志
+     */
+    public function setLogger(LoggerInterface $logger): void {
+        $this->logger = $logger;
+        $this->debug = !$logger instanceof NullLogger;
+    }
+
+    public function setDebug(bool $debug): void {
+        $this->debug = $debug;
+    }
+
+    /**
+     * 替换主循环调度函数（默认使用 LibuiApplication 的 queueMain/timer），用于无界面环境
+     *
+     * @param callable $queueMain function(callable $callback): void
+     * @param callable $timer function(int $milliseconds, callable $callback): void，回调返回 false 时停止
+     */
+    public function setScheduler(callable $queueMain, callable $timer): void {
+        $this->queueMain = $queueMain;
+        $this->timer = $timer;
+    }
+
     public function on(string $event, callable $callback, int $priority = 0): string {
-        $id = uniqid('listener_');
-        $this->listeners[$event][$priority][$id] = $callback;
-        krsort($this->listeners[$event]); // 高优先级先执行
+        $id = 'listener_' . ++$this->nextId;
+        $this->listeners[$event][$id] = [$priority, $this->nextId, $callback];
+        unset($this->compiled[$event]);
 
-        $this->getLogger()->debug("Event listener registered", [
-            'event' => $event,
-            'listener_id' => $id,
-            'priority' => $priority
-        ]);
+        if ($this->debug) {
+            $this->getLogger()->debug("Event listener registered", [
+                'event' => $event,
+                'listener_id' => $id,
+                'priority' => $priority
+            ]);
+        }
 
         return $id;
     }
 
-    public function off(string $event, string $listenerId): bool {
-        foreach ($this->listeners[$event] ?? [] as $priority => &$callbacks) {
-            if (isset($callbacks[$listenerId])) {
-                unset($callbacks[$listenerId]);
-                $this->getLogger()->debug("Event listener removed", [
-                    'event' => $event,
-                    'listener_id' => $listenerId
-                ]);
-                return true;
+    /**
+     * 合并同一轮主循环中的多次触发，只处理最后一次
+     */
+    public function onCoalesced(string $event, callable $callback, int $priority = 0): string {
+        $pending = null;
+        $id = null;
+        $queued = null;
+        $flush = function () use (&$pending, &$id, $event, $callback) {
+            [$source, $data] = $pending;
+            $pending = null;
+            $this->deliver($event, $id, $callback, $source, $data);
+        };
+        $listener = function ($source, $data) use (&$pending, &$queued, $event, $flush) {
+            $scheduled = $pending !== null;
+            $pending = [$source, $data];
+            if ($scheduled) {
+                return;
             }
+            if ($this->queueMain !== null) {
+                ($this->queueMain)($flush);
+                return;
+            }
+            // 每个监听器只创建一个 uiQueueMain 回调，之后每轮主循环重复使用
+            $queued ??= LibuiCallback::queue(
+                LibuiApplication::getInstance()->getProfiler()->wrap("queueMain coalesced $event", $flush, 'queueMain')
+            );
+            $queued->queueMain();
+        };
+        return $id = $this->on($event, $listener, $priority);
+    }
+
+    /**
+     * 停止触发 $milliseconds 毫秒后处理最后一次
+     */
+    public function onDebounced(string $event, callable $callback, int $milliseconds, int $priority = 0): string {
+        $delay = max(1, $milliseconds) / 1000;
+        $pending = null;
+        $due = 0.0;
+        $id = null;
+        $listener = function ($source, $data) use (&$pending, &$due, &$id, $event, $callback, $delay, $milliseconds) {
+            $scheduled = $pending !== null;
+            $pending = [$source, $data];
+            $due = microtime(true) + $delay;
+            if ($scheduled) {
+                return;
+            }
+            $this->schedule(min(max(1, $milliseconds), 16), function () use (&$pending, &$due, &$id, $event, $callback) {
+                if (microtime(true) < $due) {
+                    return true;
+                }
+                [$source, $data] = $pending;
+                $pending = null;
+                $this->deliver($event, $id, $callback, $source, $data);
+                return false;
+            });
+        };
+        return $id = $this->on($event, $listener, $priority);
+    }
+
+    /**
+     * 每 $milliseconds 毫秒最多处理一次：间隔足够时立即处理，否则在间隔结束时处理最后一次
+     */
+    public function onThrottled(string $event, callable $callback, int $milliseconds, int $priority = 0): string {
+        $interval = max(1, $milliseconds) / 1000;
+        $pending = null;
+        $last = 0.0;
+        $id = null;
+        $listener = function ($source, $data) use (&$pending, &$last, &$id, $event, $callback, $interval, $milliseconds) {
+            if ($pending === null && microtime(true) - $last >= $interval) {
+                $last = microtime(true);
+                $this->deliver($event, $id, $callback, $source, $data);
+                return;
+            }
+            $scheduled = $pending !== null;
+            $pending = [$source, $data];
+            if ($scheduled) {
+                return;
+            }
+            $this->schedule(min(max(1, $milliseconds), 16), function () use (&$pending, &$last, &$id, $event, $callback, $interval) {
+                if (microtime(true) - $last < $interval) {
+                    return true;
+                }
+                [$source, $data] = $pending;
+                $pending = null;
+                $last = microtime(true);
+                $this->deliver($event, $id, $callback, $source, $data);
+                return false;
+            });
+        };
+        return $id = $this->on($event, $listener, $priority);
+    }
+
+    public function off(string $event, string $listenerId): bool {
+        if (!isset($this->listeners[$event][$listenerId])) {
+            return false;
+        }
+
+        unset($this->listeners[$event][$listenerId], $this->compiled[$event]);
+        if (empty($this->listeners[$event])) {
+            unset($this->listeners[$event]);
         }
-        return false;
+
+        if ($this->debug) {
+            $this->getLogger()->debug("Event listener removed", [
+                'event' => $event,
+                'listener_id' => $listenerId
+            ]);
+        }
+        return true;
+    }
+
+    public function hasListeners(string $event): bool {
+        return !empty($this->listeners[$event]);
     }
 
     public function emit(string $event, LibuiComponent $source, mixed $data = null): void {
-        $this->getLogger()->debug("Event emitted", [
-            'event' => $event,
-            'source' => get_class($source),
-            'source_id' => $source->getId()
-        ]);
+        if ($this->debug) {
+            $this->getLogger()->debug("Event emitted", [
+                'event' => $event,
+                'source' => $source::class,
+                'source_id' => $source->getId()
+            ]);
+        }
 
-        foreach ($this->listeners[$event] ?? [] as $priority => $callbacks) {
-            foreach ($callbacks as $callback) {
-                try {
-                    $callback($source, $data);
-                } catch (\Throwable $e) {
-                    $this->getLogger()->error("Event listener error", [
-                        'event' => $event,
-                        'error' => $e->getMessage(),
-                        'trace' => $e->getTraceAsString()
-                    ]);
-                }
+        foreach ($this->compiled[$event] ?? $this->compile($event) as $callback) {
+            try {
+                $callback($source, $data);
+            } catch (\Throwable $e) {
+                $this->reportError($event, $e);
             }
         }
     }
+
+    /**
+     * 高优先级先执行，同优先级按注册顺序
+     */
+    private function compile(string $event): array {
+        if (empty($this->listeners[$event])) {
+            return [];
+        }
+        $entries = $this->listeners[$event];
+        uasort($entries, fn($a, $b) => [$b[0], $a[1]] <=> [$a[0], $b[1]]);
+        return $this->compiled[$event] = array_values(array_column($entries, 2));
+    }
+
+    /**
+     * 延迟处理的回调：监听器在等待期间被移除时不再执行
+     */
+    private function deliver(string $event, ?string $id, callable $callback, $source, $data): void {
+        if ($id === null || !isset($this->listeners[$event][$id])) {
+            return;
+        }
+        try {
+            $callback($source, $data);
+        } catch (\Throwable $e) {
+            $this->reportError($event, $e);
+        }
+    }
+
+    private function schedule(int $milliseconds, callable $callback): void {
+        if ($this->timer !== null) {
+            ($this->timer)($milliseconds, $callback);
+            return;
+        }
+        LibuiApplication::getInstance()->timer($milliseconds, $callback);
+    }
+
+    private function reportError(string $event, \Throwable $e): void {
+        $this->getLogger()->error("Event listener error", [
+            'event' => $event,
+            'error' => $e->getMessage(),
+            'trace' => $e->getTraceAsString()
+        ]);
+    }
 }
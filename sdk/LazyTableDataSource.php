@@ -0,0 +1,98 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 按需加载的表格数据源
+ *
+ * 行数据由回调按页提供，只缓存最近使用的若干页，
+ * 百万行级别的结果集也不需要整体复制到PHP数组中。
+ */
+class LazyTableDataSource implements LibuiTableDataSource
+{
+    /** @var callable(int $offset, int $limit): array */
+    private $provider;
+    private int $rowCount;
+    private int $pageSize;
+    private int $maxPages;
+    private array $pages = [];     // 页号 => 行列表，按最近使用顺序排列
+    private array $overrides = []; // 用户编辑过的单元格：行号 => [列号 => 值]
+    private int $currentPageNo = -1;
+    private array $currentPage = [];
+
+    /**
+     * @param int $rowCount 总行数
+     * @param callable $provider function(int $offset, int $limit): array 返回从 offset 开始的最多 limit 行
+     * @param int $pageSize 每页行数
+     * @param int $maxPages 最多缓存的页数
+     */
+    public function __construct(int $rowCount, callable $provider, int $pageSize = 256, int $maxPages = 64) {
+        $this->rowCount = $rowCount;
+        $this->provider = $provider;
+        $this->pageSize = max(1, $pageSize);
+        $this->maxPages = max(1, $maxPages);
+    }
+
+    public function getRowCount(): int {
+        return $this->rowCount;
+    }
+
+    /**
+     * 更新总行数（数据源本身发生变化时调用），同时清空缓存
+     */
+    public function setRowCount(int $rowCount): self {
+        $this->rowCount = $rowCount;
+        $this->invalidate();
+        return $this;
+    }
+
+    /**
+     * 清空页缓存和本地编辑
+     */
+    public function invalidate(): self {
+        $this->pages = [];
+        $this->overrides = [];
+        $this->currentPageNo = -1;
+        $this->currentPage = [];
+        return $this;
+    }
+
+    public function getCell(int $row, int $column): mixed {
+        if (isset($this->overrides[$row]) && array_key_exists($column, $this->overrides[$row])) {
+            return $this->overrides[$row][$column];
+        }
+
+        // 连续绘制的单元格通常落在同一页，直接命中当前页
+        $pageNo = intdiv($row, $this->pageSize);
+        if ($pageNo !== $this->currentPageNo) {
+            $this->currentPage = $this->loadPage($pageNo);
+            $this->currentPageNo = $pageNo;
+        }
+        return $this->currentPage[$row - $pageNo * $this->pageSize][$column] ?? null;
+    }
+
+    public function setCell(int $row, int $column, mixed $value): void {
+        if ($row >= 0 && $row < $this->rowCount) {
+            $this->overrides[$row][$column] = $value;
+        }
+    }
+
+    private function loadPage(int $pageNo): array {
+        if (isset($this->pages[$pageNo])) {
+            // 移到末尾，标记为最近使用
+            $page = $this->pages[$pageNo];
+            unset($this->pages[$pageNo]);
+            return $this->pages[$pageNo] = $page;
+        }
+
+        $offset = $pageNo * $this->pageSize;
+        $limit = min($this->pageSize, $this->rowCount - $offset);
+        $page = $limit > 0 ? array_values(($this->provider)($offset, $limit)) : [];
+
+        $this->pages[$pageNo] = $page;
+        if (count($this->pages) > $this->maxPages) {
+            unset($this->pages[array_key_first($this->pages)]);
+        }
+        return $page;
+    }
+}
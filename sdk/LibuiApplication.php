@@ -15,13 +15,19 @@ class LibuiApplication
 {
     private static ?self $instance = null;
     private EventManager $eventManager;
+    private LibuiProfiler $profiler;
     private LoggerInterface $logger;
     private array $windows = [];
     private bool $initialized = false;
     private array $screenInfo = [];
+    private array $timerJobs = [];  // 间隔毫秒 => 定时器 ID => 回调
+    private array $timerTicks = []; // 间隔毫秒 => LibuiCallback，每种间隔只创建一个 C 回调
+    private array $timerArmed = []; // 间隔毫秒 => 对应的 uiTimer 是否在运行
+    private int $nextTimerId = 0;
 
     private function __construct() {
         $this->eventManager = new EventManager();
+        $this->profiler = new LibuiProfiler();
         $this->logger = new NullLogger();
     }
 
@@ -39,6 +45,8 @@ class LibuiApplication
 
         if ($logger) {
             $this->logger = $logger;
+            $this->eventManager->setLogger($logger);
+            $this->profiler->setLogger($logger);
         }
 
         App::init();
@@ -48,6 +56,10 @@ class LibuiApplication
         return $this;
     }
 
+    public function isInitialized(): bool {
+        return $this->initialized;
+    }
+
     public function createWindow(string $title, int $width = 640, int $height = 480): LibuiWindow {
         $window = new LibuiWindow($title, $width, $height);
         $this->windows[$window->getId()] = $window;
@@ -83,13 +95,93 @@ class LibuiApplication
      * @return void
      */
     public function queueMain(callable $callable): void {
+        if ($this->profiler->isEnabled()) {
+            $callable = $this->profiler->wrap('queueMain ' . LibuiProfiler::describe($callable), $callable, 'queueMain');
+        }
         App::queueMain($callable);
     }
 
+    /**
+     * 注册重复执行的定时器
+     *
+     * 相同间隔的定时器共用一个 uiTimer，由它依次调用；每种间隔只创建一次 C 回调，
+     * 所以反复注册短期定时器不会累积 FFI 回调。加入已在运行的 uiTimer 时，第一次调用会早于 $milliseconds。
+     *
+     * @param int $milliseconds 间隔毫秒数
+     * @param callable $callable 回调返回 false 时停止定时器
+     * @return int 定时器 ID，可用于 clearTimer()
+     */
+    public function timer(int $milliseconds, callable $callable): int {
+        if ($this->profiler->isEnabled()) {
+            $callable = $this->profiler->wrap('timer ' . LibuiProfiler::describe($callable), $callable, 'timer');
+        }
+        $milliseconds = max(1, $milliseconds);
+        $id = ++$this->nextTimerId;
+        $this->timerJobs[$milliseconds][$id] = $callable;
+
+        if (empty($this->timerArmed[$milliseconds])) {
+            $this->timerArmed[$milliseconds] = true;
+            $this->timerTicks[$milliseconds] ??= LibuiCallback::timer(fn() => $this->tick($milliseconds));
+            // Kingbes\Libui\App::timer 丢弃了回调返回值，只会执行一次，这里直接调用 uiTimer
+            App::ffi()->uiTimer($milliseconds, $this->timerTicks[$milliseconds]->getPointer(), null);
+        }
+        return $id;
+    }
+
+    public function clearTimer(int $id): void {
+        foreach (array_keys($this->timerJobs) as $milliseconds) {
+            unset($this->timerJobs[$milliseconds][$id]);
+        }
+    }
+
+    /**
+     * uiTimer 回调：调用该间隔的所有定时器，没有定时器时返回 false 停止 uiTimer
+     */
+    private function tick(int $milliseconds): bool {
+        foreach ($this->timerJobs[$milliseconds] ?? [] as $id => $callable) {
+            // 前面的回调可能已经清除了这个定时器
+            if (!isset($this->timerJobs[$milliseconds][$id])) {
+                continue;
+            }
+            try {
+                $keep = $callable() !== false;
+            } catch (Throwable $e) {
+                $this->logger->error("Timer callback error", ['error' => $e->getMessage()]);
+                $keep = false;
+            }
+            if (!$keep) {
+                unset($this->timerJobs[$milliseconds][$id]);
+            }
+        }
+
+        if (empty($this->timerJobs[$milliseconds])) {
+            unset($this->timerJobs[$milliseconds]);
+            $this->timerArmed[$milliseconds] = false;
+            return false;
+        }
+        return true;
+    }
+
     public function getEventManager(): EventManager {
         return $this->eventManager;
     }
 
+    public function getProfiler(): LibuiProfiler {
+        return $this->profiler;
+    }
+
+    /**
+     * 启用回调性能分析，需要在创建界面之前调用
+     *
+     * @param float $thresholdMs 超过该耗时的回调视为阻塞主循环
+     * @param int $capacity 环形缓冲保存的调用数
+     */
+    public function enableProfiler(float $thresholdMs = 16.0, int $capacity = 4096): LibuiProfiler {
+        $this->profiler->enable($thresholdMs, $capacity);
+        $this->logger->info("Profiler enabled", ['threshold_ms' => $thresholdMs, 'capacity' => $capacity]);
+        return $this->profiler;
+    }
+
     public function getLogger(): LoggerInterface {
         return $this->logger;
     }
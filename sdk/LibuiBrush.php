@@ -3,7 +3,7 @@
 namespace Kingbes\Libui\SDK;
 
 use FFI\CData;
-use Kingbes\Libui\Draw;
+use Kingbes\Libui\Base;
 use Kingbes\Libui\DrawBrushType;
 
 /**
@@ -11,14 +11,18 @@ use Kingbes\Libui\DrawBrushType;
  */
 class LibuiBrush
 {
+    private CData $brush;
     private CData $handle;
 
     public function __construct(float $r, float $g, float $b, float $a = 1.0) {
-        $this->handle = Draw::createBrush(DrawBrushType::Solid);
-        $this->handle->R = $r;
-        $this->handle->G = $g;
-        $this->handle->B = $b;
-        $this->handle->A = $a;
+        // 结构体由本对象持有，Draw::createBrush 返回的指针指向的临时结构体可能已被释放
+        $this->brush = Base::ffi()->new("uiDrawBrush");
+        $this->brush->Type = DrawBrushType::Solid->value;
+        $this->brush->R = $r;
+        $this->brush->G = $g;
+        $this->brush->B = $b;
+        $this->brush->A = $a;
+        $this->handle = \FFI::addr($this->brush);
     }
 
     public function getHandle(): CData {
@@ -24,10 +24,10 @@ class LibuiButton extends LibuiComponent
     }
 
     private function setupButtonEvents(): void {
-        Button::onClicked($this->handle, function() {
+        Button::onClicked($this->handle, $this->profiler->wrap('button.onClicked', function() {
             // 发出特定于该按钮的事件
             $this->emit('button.clicked.' . $this->getId());
-        });
+        }));
     }
 
     // 便捷方法
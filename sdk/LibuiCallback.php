@@ -0,0 +1,58 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+use FFI;
+use FFI\CData;
+use Kingbes\Libui\Base;
+
+/**
+ * 可以反复传给 uiTimer/uiQueueMain 的 C 回调
+ *
+ * PHP FFI 每次把闭包作为函数指针传入都会生成一个新的跳板，直到进程结束才释放。
+ * 这里把闭包写入一个结构体字段，只生成一次跳板，之后每次都传入同一个函数指针。
+ */
+final class LibuiCallback
+{
+    private static ?FFI $types = null;
+
+    private CData $holder;  // 持有跳板的结构体，必须与回调同生命周期
+    private CData $pointer;
+
+    private function __construct(string $field, \Closure $closure) {
+        self::$types ??= FFI::cdef('typedef struct { int (*timer)(void *data); void (*queue)(void *data); } uiPhpCallback;');
+        $this->holder = self::$types->new('uiPhpCallback');
+        $this->holder->$field = $closure;
+        // 函数指针类型只在同一个 FFI 实例内兼容，转换为 void * 后才能传给 libui 的函数
+        $this->pointer = Base::ffi()->cast('void *', $this->holder->$field);
+    }
+
+    /**
+     * uiTimer 回调：$callback 返回 false 时停止
+     */
+    public static function timer(callable $callback): self {
+        return new self('timer', function ($data) use ($callback) {
+            return $callback() === false ? 0 : 1;
+        });
+    }
+
+    /**
+     * uiQueueMain 回调
+     */
+    public static function queue(callable $callback): self {
+        return new self('queue', function ($data) use ($callback) {
+            $callback();
+        });
+    }
+
+    public function getPointer(): CData {
+        return $this->pointer;
+    }
+
+    /**
+     * 把 queue() 创建的回调加入主循环队列
+     */
+    public function queueMain(): void {
+        Base::ffi()->uiQueueMain($this->pointer, null);
+    }
+}
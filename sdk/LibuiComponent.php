@@ -13,12 +13,14 @@ abstract class LibuiComponent
     protected ?LibuiComponent $parent = null;
     protected array $children = [];
     protected EventManager $eventManager;
+    protected LibuiProfiler $profiler;
     protected LoggerInterface $logger;
     protected array $eventListeners = [];
 
     public function __construct() {
         $this->id = uniqid(static::class . '_');
         $this->eventManager = LibuiApplication::getInstance()->getEventManager();
+        $this->profiler = LibuiApplication::getInstance()->getProfiler();
         $this->logger = LibuiApplication::getInstance()->getLogger();
 
         $this->logger->debug("Component created", [
@@ -82,11 +84,45 @@ abstract class LibuiComponent
     public function on(string $event, callable $callback, int $priority = 0): string {
         // 为事件添加组件特定的标识符
         $specificEvent = $event . '.' . $this->getId();
-        $listenerId = $this->eventManager->on($specificEvent, $callback, $priority);
+        $listenerId = $this->eventManager->on($specificEvent, $this->profileListener($event, $callback), $priority);
         $this->eventListeners[] = [$specificEvent, $listenerId];
         return $listenerId;
     }
 
+    /**
+     * 同一轮主循环中多次触发只处理最后一次（适合滑块拖动等高频事件）
+     */
+    public function onCoalesced(string $event, callable $callback, int $priority = 0): string {
+        $specificEvent = $event . '.' . $this->getId();
+        $listenerId = $this->eventManager->onCoalesced($specificEvent, $this->profileListener($event, $callback), $priority);
+        $this->eventListeners[] = [$specificEvent, $listenerId];
+        return $listenerId;
+    }
+
+    public function onDebounced(string $event, callable $callback, int $milliseconds, int $priority = 0): string {
+        $specificEvent = $event . '.' . $this->getId();
+        $listenerId = $this->eventManager->onDebounced($specificEvent, $this->profileListener($event, $callback), $milliseconds, $priority);
+        $this->eventListeners[] = [$specificEvent, $listenerId];
+        return $listenerId;
+    }
+
+    public function onThrottled(string $event, callable $callback, int $milliseconds, int $priority = 0): string {
+        $specificEvent = $event . '.' . $this->getId();
+        $listenerId = $this->eventManager->onThrottled($specificEvent, $this->profileListener($event, $callback), $milliseconds, $priority);
+        $this->eventListeners[] = [$specificEvent, $listenerId];
+        return $listenerId;
+    }
+
+    /**
+     * 启用性能分析时为事件监听计时，名称为 事件名 + 回调位置
+     */
+    private function profileListener(string $event, callable $callback): callable {
+        if (!$this->profiler->isEnabled()) {
+            return $callback;
+        }
+        return $this->profiler->wrap($event . ' ' . LibuiProfiler::describe($callback), $callback, 'listener');
+    }
+
     // 获取组件类型的方法
     public function getComponentType(): string {
         $class = get_class($this);
@@ -130,6 +166,11 @@ abstract class LibuiComponent
     }
 
     public function emit(string $event, mixed $data = null): void {
+        // on() 订阅的是带组件 ID 的事件名，部分子类触发时没有带上
+        $suffix = '.' . $this->id;
+        if (!str_ends_with($event, $suffix)) {
+            $event .= $suffix;
+        }
         $this->eventManager->emit($event, $this, $data);
     }
 
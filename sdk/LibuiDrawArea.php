@@ -3,10 +3,17 @@
 namespace Kingbes\Libui\SDK;
 
 use FFI\CData;
+use Kingbes\Libui\App;
 use Kingbes\Libui\Area;
+use Kingbes\Libui\Base;
 
 /**
  * 绘图区域组件
+ *
+ * 可以在 onDraw 回调中每帧直接绘制，也可以通过 setScene() 使用保留模式的显示列表；
+ * 两者同时存在时先绘制场景，再调用 onDraw 回调绘制在上层。
+ * 滚动区域（$scrolling）的尺寸由 setSize() 决定，超出窗口的部分可以滚动查看，
+ * 场景只绘制当前可见部分的节点。
  */
 class LibuiDrawArea extends LibuiComponent
 {
@@ -15,22 +22,34 @@ class LibuiDrawArea extends LibuiComponent
     private $keyHandler = null;
     private int $width = 400;
     private int $height = 400;
+    private bool $scrolling;
+    private ?CData $areaHandler = null; // libui 保存的是处理程序的指针，必须与区域同生命周期
+    private ?LibuiDrawContext $drawContext = null;
+    private ?LibuiScene $scene = null;
+    private ?\Closure $sceneListener = null;
+    private bool $redrawQueued = false;
+    private ?LibuiCallback $queuedRedraw = null; // 每个区域一个 uiQueueMain 回调，每帧重复使用
 
-    public function __construct(int $width = 400, int $height = 400) {
+    public function __construct(int $width = 400, int $height = 400, bool $scrolling = false) {
         parent::__construct();
         $this->width = $width;
         $this->height = $height;
+        $this->scrolling = $scrolling;
         $this->handle = $this->createHandle();
     }
 
     protected function createHandle(): CData {
-        $handler = Area::handler(
+        $this->areaHandler = Area::handler(
             $this->getDrawCallback(),
             $this->getKeyCallback(),
             $this->getMouseCallback()
         );
 
-        return Area::create($handler);
+        if ($this->scrolling) {
+            // Area::createScroll 会把结构体直接转换为指针，这里传入结构体地址
+            return Base::ffi()->uiNewScrollingArea(\FFI::addr($this->areaHandler), $this->width, $this->height);
+        }
+        return Area::create($this->areaHandler);
     }
 
     public function onDraw(callable $callback): self {
@@ -48,6 +67,26 @@ class LibuiDrawArea extends LibuiComponent
         return $this;
     }
 
+    /**
+     * 使用保留模式的显示列表，场景变化时自动重绘
+     */
+    public function setScene(LibuiScene $scene): self {
+        $this->sceneListener ??= function () {
+            $this->invalidate();
+        };
+        if ($this->scene !== null) {
+            $this->scene->offInvalidate($this->sceneListener);
+        }
+        $this->scene = $scene;
+        $scene->onInvalidate($this->sceneListener);
+        $this->invalidate();
+        return $this;
+    }
+
+    public function getScene(): ?LibuiScene {
+        return $this->scene;
+    }
+
     public function setSize(int $width, int $height): self {
         $this->width = $width;
         $this->height = $height;
@@ -55,34 +94,71 @@ class LibuiDrawArea extends LibuiComponent
         return $this;
     }
 
+    /**
+     * 滚动使指定区域可见（仅滚动区域）
+     */
+    public function scrollTo(float $x, float $y, float $width, float $height): self {
+        Area::scrollTo($this->handle, $x, $y, $width, $height);
+        return $this;
+    }
+
     public function redraw(): self {
         Area::queueRedraw($this->handle);
         return $this;
     }
 
+    /**
+     * 请求重绘，同一轮主循环中的多次请求只重绘一次
+     */
+    public function invalidate(): self {
+        if ($this->redrawQueued) {
+            return $this;
+        }
+        $this->redrawQueued = true;
+        $this->queuedRedraw ??= LibuiCallback::queue($this->profiler->wrap('area.QueueRedraw', function () {
+            $this->redrawQueued = false;
+            Area::queueRedraw($this->handle);
+        }, 'area'));
+        App::ffi()->uiQueueMain($this->queuedRedraw->getPointer(), null);
+        return $this;
+    }
+
     private function getDrawCallback(): callable {
-        return function($handler, $area, $params) {
+        return $this->profiler->wrap('area.Draw', function($handler, $area, $params) {
+            if ($this->scene === null && !$this->drawHandler) {
+                return;
+            }
+            if ($this->drawContext === null) {
+                $this->drawContext = new LibuiDrawContext($params);
+            } else {
+                $this->drawContext->setParams($params);
+            }
+            if ($this->scene !== null) {
+                $this->scene->render($this->drawContext);
+            }
             if ($this->drawHandler) {
-                $drawContext = new LibuiDrawContext($params);
-                ($this->drawHandler)($drawContext);
+                ($this->drawHandler)($this->drawContext);
             }
-        };
+        }, 'area');
     }
 
+    /**
+     * 鼠标移动时调用非常频繁，性能分析只计入直方图
+     */
     private function getMouseCallback(): callable {
-        return function($handler, $area, $mouseEvent) {
+        return $this->profiler->wrap('area.MouseEvent', function($handler, $area, $mouseEvent) {
             if ($this->mouseHandler) {
                 ($this->mouseHandler)($mouseEvent);
             }
-        };
+        }, 'area', false);
     }
 
     private function getKeyCallback(): callable {
-        return function($handler, $area, $keyEvent) {
+        return $this->profiler->wrap('area.KeyEvent', function($handler, $area, $keyEvent) {
             if ($this->keyHandler) {
                 return ($this->keyHandler)($keyEvent) ? 1 : 0;
             }
             return 0;
-        };
+        }, 'area');
     }
 }
@@ -0,0 +1,92 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+use Kingbes\Libui\DrawLineCap;
+use Kingbes\Libui\DrawLineJoin;
+
+/**
+ * 绘图资源缓存
+ *
+ * 按内容缓存画刷、描边参数和路径，相同内容只通过 FFI 创建一次。
+ * 三者各自的数量都以 maxPaths 为上限，超出时释放最久未使用的一项（颜色或线宽连续变化的动画不会无限增长）。
+ */
+class LibuiDrawCache
+{
+    private array $brushes = []; // 内容键 => LibuiBrush，按最近使用顺序排列
+    private array $strokes = []; // 内容键 => LibuiStrokeParams，按最近使用顺序排列
+    private array $paths = []; // 内容键 => LibuiPath，按最近使用顺序排列
+    private int $maxPaths;
+    private int $hits = 0;
+    private int $misses = 0;
+
+    public function __construct(int $maxPaths = 512) {
+        $this->maxPaths = max(1, $maxPaths);
+    }
+
+    public function brush(float $r, float $g, float $b, float $a = 1.0): LibuiBrush {
+        return $this->lookup($this->brushes, "$r,$g,$b,$a", fn() => new LibuiBrush($r, $g, $b, $a));
+    }
+
+    public function stroke(float $thickness, DrawLineCap $cap = DrawLineCap::Flat, DrawLineJoin $join = DrawLineJoin::Miter): LibuiStrokeParams {
+        return $this->lookup($this->strokes, "$thickness,{$cap->value},{$join->value}", fn() => (new LibuiStrokeParams($thickness))
+            ->setCap($cap)
+            ->setJoin($join));
+    }
+
+    /**
+     * 获取内容键对应的路径，不存在时调用 $build 填充新路径
+     */
+    public function path(string $key, callable $build): LibuiPath {
+        if (isset($this->paths[$key])) {
+            $path = $this->paths[$key];
+            unset($this->paths[$key]);
+            $this->paths[$key] = $path;
+            $this->hits++;
+            return $path;
+        }
+
+        $this->misses++;
+        $path = new LibuiPath();
+        $build($path);
+        $path->end();
+        $this->paths[$key] = $path;
+
+        if (count($this->paths) > $this->maxPaths) {
+            unset($this->paths[array_key_first($this->paths)]);
+        }
+        return $path;
+    }
+
+    /**
+     * 最近最少使用缓存：命中时移到末尾，超出上限时移除最前面的一项
+     */
+    private function lookup(array &$cache, string $key, callable $create): object {
+        if (isset($cache[$key])) {
+            $value = $cache[$key];
+            unset($cache[$key]);
+            return $cache[$key] = $value;
+        }
+        $cache[$key] = $value = $create();
+        if (count($cache) > $this->maxPaths) {
+            unset($cache[array_key_first($cache)]);
+        }
+        return $value;
+    }
+
+    public function clear(): void {
+        $this->brushes = [];
+        $this->strokes = [];
+        $this->paths = [];
+    }
+
+    public function getStats(): array {
+        return [
+            'paths' => count($this->paths),
+            'brushes' => count($this->brushes),
+            'strokes' => count($this->strokes),
+            'hits' => $this->hits,
+            'misses' => $this->misses,
+        ];
+    }
+}
@@ -3,18 +3,24 @@
 namespace Kingbes\Libui\SDK;
 
 use FFI\CData;
+use Kingbes\Libui\Draw;
 
 /**
  * 绘图上下文封装
+ *
+ * 同一个绘图区域在每次 Draw 时复用，通过 setParams() 更新本次的绘制参数。
  */
 class LibuiDrawContext
 {
     private CData $params;
-    private CData $context;
 
     public function __construct(CData $params) {
         $this->params = $params;
-        $this->context = $params->Context;
+    }
+
+    public function setParams(CData $params): self {
+        $this->params = $params;
+        return $this;
     }
 
     public function getWidth(): float {
@@ -25,17 +31,25 @@ class LibuiDrawContext
         return $this->params->AreaHeight;
     }
 
+    /**
+     * 本次需要重绘的区域 [x, y, width, height]，滚动区域中即当前可见部分
+     */
+    public function getClip(): array {
+        return [$this->params->ClipX, $this->params->ClipY, $this->params->ClipWidth, $this->params->ClipHeight];
+    }
+
     public function createPath(): LibuiPath {
         return new LibuiPath();
     }
 
+    // Draw::Stroke/fill 需要的是绘制参数指针，内部再取 Context
     public function stroke(LibuiPath $path, LibuiBrush $brush, LibuiStrokeParams $stroke): self {
-        \Kingbes\Libui\Draw::stroke($this->context, $path->getHandle(), $brush->getHandle(), $stroke->getHandle());
+        Draw::Stroke($this->params, $path->getHandle(), $brush->getHandle(), $stroke->getHandle());
         return $this;
     }
 
     public function fill(LibuiPath $path, LibuiBrush $brush): self {
-        \Kingbes\Libui\Draw::fill($this->context, $path->getHandle(), $brush->getHandle());
+        Draw::fill($this->params, $path->getHandle(), $brush->getHandle());
         return $this;
     }
 }
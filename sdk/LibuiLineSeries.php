@@ -0,0 +1,148 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 实时折线节点
+ *
+ * 数据保存在固定容量的环形缓冲中，push() 追加新数据并丢弃最旧的数据。
+ * 生成路径时按像素列取每列的最小/最大值，点数再多路径也只有约 2×宽度 个顶点，
+ * 数据每帧都在变化，所以路径由节点自己持有，不放进按内容缓存的 LibuiDrawCache。
+ */
+class LibuiLineSeries extends LibuiSceneNode
+{
+    private array $values = [];
+    private int $capacity;
+    private int $head = 0; // 缓冲已满时最旧数据的位置
+    private float $x;
+    private float $y;
+    private float $width;
+    private float $height;
+    private ?float $min = null;
+    private ?float $max = null;
+    private ?LibuiPath $path = null;
+
+    public function __construct(float $x, float $y, float $width, float $height, int $capacity = 1000) {
+        $this->x = $x;
+        $this->y = $y;
+        $this->width = $width;
+        $this->height = $height;
+        $this->capacity = max(2, $capacity);
+        $this->stroke = [0.2, 0.5, 0.9, 1.0, 1.5];
+    }
+
+    public function push(float ...$values): self {
+        foreach ($values as $value) {
+            if (count($this->values) < $this->capacity) {
+                $this->values[] = $value;
+            } else {
+                $this->values[$this->head] = $value;
+                $this->head = ($this->head + 1) % $this->capacity;
+            }
+        }
+        return $this->changed();
+    }
+
+    public function setData(array $values): self {
+        $this->values = array_map('floatval', array_slice(array_values($values), -$this->capacity));
+        $this->head = 0;
+        return $this->changed();
+    }
+
+    /**
+     * 按时间顺序返回当前数据
+     */
+    public function getData(): array {
+        if ($this->head === 0) {
+            return $this->values;
+        }
+        return array_merge(array_slice($this->values, $this->head), array_slice($this->values, 0, $this->head));
+    }
+
+    /**
+     * 固定纵轴范围，传 null 时按当前数据自动计算
+     */
+    public function setRange(?float $min, ?float $max): self {
+        $this->min = $min;
+        $this->max = $max;
+        return $this->changed();
+    }
+
+    public function setViewport(float $x, float $y, float $width, float $height): self {
+        $this->x = $x;
+        $this->y = $y;
+        $this->width = $width;
+        $this->height = $height;
+        return $this->changed();
+    }
+
+    public function getBounds(): array {
+        $margin = $this->stroke !== null ? $this->stroke[4] / 2 : 0.0;
+        return [$this->x - $margin, $this->y - $margin, $this->x + $this->width + $margin, $this->y + $this->height + $margin];
+    }
+
+    public function buildPath(LibuiPath $path): void {
+        $values = $this->getData();
+        $count = count($values);
+        if ($count < 2) {
+            return;
+        }
+
+        $min = $this->min ?? min($values);
+        $max = $this->max ?? max($values);
+        $scale = $max > $min ? $this->height / ($max - $min) : 0.0;
+        $bottom = $this->y + $this->height;
+        $toY = fn(float $value) => $bottom - (max($min, min($max, $value)) - $min) * $scale;
+
+        $columns = max(1, (int)$this->width);
+        if ($count <= $columns * 2) {
+            $step = $this->width / ($count - 1);
+            $path->newFigure($this->x, $toY($values[0]));
+            for ($i = 1; $i < $count; $i++) {
+                $path->lineTo($this->x + $i * $step, $toY($values[$i]));
+            }
+            return;
+        }
+
+        // 每个像素列只保留最小值和最大值，按出现顺序连接
+        $path->newFigure($this->x, $toY($values[0]));
+        for ($column = 0; $column < $columns; $column++) {
+            $start = intdiv($column * $count, $columns);
+            $end = intdiv(($column + 1) * $count, $columns);
+            $low = $high = $start;
+            for ($i = $start + 1; $i < $end; $i++) {
+                if ($values[$i] < $values[$low]) {
+                    $low = $i;
+                } elseif ($values[$i] > $values[$high]) {
+                    $high = $i;
+                }
+            }
+            $x = $this->x + $column;
+            if ($low < $high) {
+                $path->lineTo($x, $toY($values[$low]));
+                $path->lineTo($x, $toY($values[$high]));
+            } else {
+                $path->lineTo($x, $toY($values[$high]));
+                $path->lineTo($x, $toY($values[$low]));
+            }
+        }
+    }
+
+    public function render(LibuiDrawContext $context, LibuiDrawCache $cache): void {
+        if (count($this->values) < 2) {
+            return;
+        }
+        if ($this->path === null) {
+            $this->path = new LibuiPath();
+            $this->buildPath($this->path);
+            $this->path->end();
+            $this->scene?->countRebuild();
+        }
+        $this->paint($context, $cache, $this->path);
+    }
+
+    protected function changed(): self {
+        $this->path = null;
+        return parent::changed();
+    }
+}
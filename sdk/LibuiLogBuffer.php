@@ -0,0 +1,109 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 多行文本框的日志缓冲
+ *
+ * 最多保留 maxLines 行（环形缓冲），追加的文本先缓存，每个主循环周期最多刷新一次界面：
+ * 通常只追加新文本；超出行数上限后，文本框中允许多留一段旧行，丢弃的行累计到
+ * maxLines 的十分之一时才整体重设一次文本，输出很多的进程也不会每帧重写整个文本框。
+ */
+class LibuiLogBuffer
+{
+    private LibuiMultilineEntry $entry;
+    private int $maxLines;
+
+    private array $lines = [];     // 环形缓冲
+    private int $head = 0;         // 最旧一行的位置
+    private int $count = 0;
+    private string $partial = '';  // 尚未换行的最后一行
+
+    private string $pending = '';  // 上次刷新后追加的文本
+    private int $dropped = 0;      // 上次整体重设后丢弃、但仍显示在文本框中的行数
+    private int $trimLines;        // 丢弃的行数达到此值时整体重设文本
+    private bool $truncated = false; // 下次刷新时强制整体重设
+    private bool $scheduled = false;
+    private ?LibuiCallback $flushCallback = null; // 每个缓冲一个 uiQueueMain 回调，重复使用
+
+    public function __construct(LibuiMultilineEntry $entry, int $maxLines = 5000) {
+        $this->entry = $entry;
+        $this->maxLines = max(1, $maxLines);
+        $this->trimLines = max(1, intdiv($this->maxLines, 10));
+        $this->lines = array_fill(0, $this->maxLines, '');
+    }
+
+    public function append(string $text): self {
+        if ($text === '') {
+            return $this;
+        }
+        $this->pending .= $text;
+
+        $parts = explode("\n", $this->partial . $text);
+        $this->partial = array_pop($parts);
+        foreach ($parts as $line) {
+            $this->push($line);
+        }
+
+        if (!$this->scheduled) {
+            $this->scheduled = true;
+            $this->flushCallback ??= LibuiCallback::queue(
+                LibuiApplication::getInstance()->getProfiler()->wrap('queueMain LibuiLogBuffer::flush', [$this, 'flush'], 'queueMain')
+            );
+            $this->flushCallback->queueMain();
+        }
+        return $this;
+    }
+
+    /**
+     * 清空并设置文本（立即生效）
+     */
+    public function setText(string $text): self {
+        $this->head = 0;
+        $this->count = 0;
+        $this->partial = '';
+        $this->pending = '';
+        $this->dropped = 0;
+        $this->truncated = false;
+        $this->append($text);
+        $this->truncated = true;
+        return $this->flush();
+    }
+
+    public function getText(): string {
+        $lines = [];
+        for ($i = 0; $i < $this->count; $i++) {
+            $lines[] = $this->lines[($this->head + $i) % $this->maxLines];
+        }
+        $lines[] = $this->partial;
+        return implode("\n", $lines);
+    }
+
+    /**
+     * 把缓存的文本写入文本框
+     */
+    public function flush(): self {
+        $this->scheduled = false;
+        if ($this->truncated || $this->dropped >= $this->trimLines) {
+            $this->entry->setText($this->getText());
+            $this->dropped = 0;
+        } elseif ($this->pending !== '') {
+            $this->entry->append($this->pending);
+        }
+        $this->pending = '';
+        $this->truncated = false;
+        return $this;
+    }
+
+    private function push(string $line): void {
+        if ($this->count < $this->maxLines) {
+            $this->lines[($this->head + $this->count) % $this->maxLines] = $line;
+            $this->count++;
+            return;
+        }
+        // 已满，覆盖最旧的一行
+        $this->lines[$this->head] = $line;
+        $this->head = ($this->head + 1) % $this->maxLines;
+        $this->dropped++;
+    }
+}
@@ -41,6 +41,15 @@ class LibuiMultilineEntry extends LibuiComponent
         return $this;
     }
 
+    /**
+     * 追加文本，不重新设置整个内容
+     */
+    public function append(string $text): self {
+        $this->text .= $text;
+        MultilineEntry::append($this->handle, $text);
+        return $this;
+    }
+
     public function getText(): string {
         return $this->text;
     }
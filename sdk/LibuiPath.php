@@ -4,6 +4,7 @@ namespace Kingbes\Libui\SDK;
 
 use FFI\CData;
 use Kingbes\Libui\Draw;
+use Kingbes\Libui\DrawFillMode;
 
 /**
  * 绘图路径封装
@@ -12,8 +13,8 @@ class LibuiPath
 {
     private CData $handle;
 
-    public function __construct() {
-        $this->handle = Draw::createPath(\Kingbes\Libui\DrawFillMode::Winding);
+    public function __construct(DrawFillMode $fillMode = DrawFillMode::Winding) {
+        $this->handle = Draw::createPath($fillMode);
     }
 
     public function getHandle(): CData {
@@ -30,6 +31,26 @@ class LibuiPath
         return $this;
     }
 
+    public function newFigureWithArc(float $xCenter, float $yCenter, float $radius, float $startAngle, float $sweep, bool $negative = false): self {
+        Draw::createPathFigureWithArc($this->handle, $xCenter, $yCenter, $radius, $startAngle, $sweep, $negative);
+        return $this;
+    }
+
+    public function arcTo(float $xCenter, float $yCenter, float $radius, float $startAngle, float $sweep, bool $negative = false): self {
+        Draw::pathArcTo($this->handle, $xCenter, $yCenter, $radius, $startAngle, $sweep, $negative);
+        return $this;
+    }
+
+    public function bezierTo(float $c1x, float $c1y, float $c2x, float $c2y, float $endX, float $endY): self {
+        Draw::pathBezierTo($this->handle, $c1x, $c1y, $c2x, $c2y, $endX, $endY);
+        return $this;
+    }
+
+    public function closeFigure(): self {
+        Draw::pathCloseFigure($this->handle);
+        return $this;
+    }
+
     public function rectangle(float $x, float $y, float $width, float $height): self {
         Draw::pathAddRectangle($this->handle, $x, $y, $width, $height);
         return $this;
@@ -0,0 +1,353 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+use RuntimeException;
+
+/**
+ * 异步子进程
+ *
+ * 子进程的输出由主循环上的 uiTimer 轮询读取（stream_select 超时为0，不会阻塞），
+ * 按行回调，界面在进程运行期间保持响应。所有运行中的进程共用一个定时器，
+ * 没有运行中的进程时定时器自动停止。
+ */
+class LibuiProcess
+{
+    public const STDOUT = 'stdout';
+    public const STDERR = 'stderr';
+
+    // 轮询间隔（毫秒），约一帧
+    private const POLL_INTERVAL = 16;
+    // 每次轮询每个输出流最多读取的字节数，避免大量输出占满一帧
+    private const READ_BUDGET = 65536;
+    // 没有换行的超长输出按此长度强制切分
+    private const MAX_LINE_LENGTH = 1048576;
+    // 取消后等待进程退出的秒数，超时则强制结束
+    private const KILL_GRACE = 2.0;
+
+    /** @var LibuiProcess[] */
+    private static array $running = [];
+    private static bool $polling = false;
+
+    private array|string $command;
+    private ?string $cwd;
+    private ?array $env;
+    private float $timeout = 0.0;
+
+    private $process = null;
+    private array $streams = [];  // 流名 => 管道（Windows 下为临时文件句柄）
+    private array $tempFiles = []; // Windows 下的输出临时文件
+    private array $buffers = [self::STDOUT => '', self::STDERR => ''];
+    private array $lineCallbacks = [];
+    private array $exitCallbacks = [];
+
+    private float $startedAt = 0.0;
+    private ?float $cancelledAt = null;
+    private bool $timedOut = false;
+    private ?int $exitCode = null;
+
+    /**
+     * @param array|string $command 数组形式不经过 shell，字符串形式由 shell 执行
+     * @param string|null $cwd 工作目录
+     * @param array|null $env 环境变量
+     */
+    public function __construct(array|string $command, ?string $cwd = null, ?array $env = null) {
+        $this->command = $command;
+        $this->cwd = $cwd;
+        $this->env = $env;
+    }
+
+    /**
+     * 运行命令并在结束后一次性返回输出
+     *
+     * @param callable $callback function(array $stdoutLines, int $exitCode, array $stderrLines, LibuiProcess $process)
+     */
+    public static function run(array|string $command, callable $callback, float $timeout = 0.0): self {
+        $stdout = [];
+        $stderr = [];
+        return (new self($command))
+            ->setTimeout($timeout)
+            ->onLine(function (string $line, string $stream) use (&$stdout, &$stderr) {
+                if ($stream === self::STDOUT) {
+                    $stdout[] = $line;
+                } else {
+                    $stderr[] = $line;
+                }
+            })
+            ->onExit(function (int $exitCode, LibuiProcess $process) use (&$stdout, &$stderr, $callback) {
+                $callback($stdout, $exitCode, $stderr, $process);
+            })
+            ->start();
+    }
+
+    /**
+     * 设置超时秒数，超时后自动取消，0 表示不限制
+     */
+    public function setTimeout(float $seconds): self {
+        $this->timeout = max(0.0, $seconds);
+        return $this;
+    }
+
+    /**
+     * 每输出一行回调一次（不含换行符）
+     *
+     * @param callable $callback function(string $line, string $stream, LibuiProcess $process)
+     */
+    public function onLine(callable $callback): self {
+        $this->lineCallbacks[] = $callback;
+        return $this;
+    }
+
+    /**
+     * 进程结束（包括取消、超时）时回调
+     *
+     * @param callable $callback function(int $exitCode, LibuiProcess $process)
+     */
+    public function onExit(callable $callback): self {
+        $this->exitCallbacks[] = $callback;
+        return $this;
+    }
+
+    public function start(): self {
+        if ($this->process !== null) {
+            throw new RuntimeException("Process already started");
+        }
+
+        if (PHP_OS_FAMILY === 'Windows') {
+            // Windows 的管道不支持非阻塞读取和 stream_select，改为输出到临时文件后增量读取
+            $this->tempFiles[self::STDOUT] = tempnam(sys_get_temp_dir(), 'lpo');
+            $this->tempFiles[self::STDERR] = tempnam(sys_get_temp_dir(), 'lpe');
+            $descriptors = [
+                0 => ['pipe', 'r'],
+                1 => ['file', $this->tempFiles[self::STDOUT], 'w'],
+                2 => ['file', $this->tempFiles[self::STDERR], 'w'],
+            ];
+        } else {
+            $descriptors = [
+                0 => ['pipe', 'r'],
+                1 => ['pipe', 'w'],
+                2 => ['pipe', 'w'],
+            ];
+        }
+
+        $process = proc_open($this->command, $descriptors, $pipes, $this->cwd, $this->env);
+        if (!is_resource($process)) {
+            $this->removeTempFiles();
+            throw new RuntimeException("Failed to start process: " . $this->getCommandLine());
+        }
+        fclose($pipes[0]);
+
+        $this->process = $process;
+        if (PHP_OS_FAMILY === 'Windows') {
+            $this->streams[self::STDOUT] = fopen($this->tempFiles[self::STDOUT], 'rb');
+            $this->streams[self::STDERR] = fopen($this->tempFiles[self::STDERR], 'rb');
+        } else {
+            stream_set_blocking($pipes[1], false);
+            stream_set_blocking($pipes[2], false);
+            $this->streams[self::STDOUT] = $pipes[1];
+            $this->streams[self::STDERR] = $pipes[2];
+        }
+        $this->startedAt = microtime(true);
+
+        self::$running[spl_object_id($this)] = $this;
+        self::ensurePolling();
+
+        return $this;
+    }
+
+    /**
+     * 取消进程：先发送 SIGTERM，超过宽限时间仍未退出则强制结束
+     */
+    public function cancel(): void {
+        if ($this->isRunning() && $this->cancelledAt === null) {
+            $this->cancelledAt = microtime(true);
+            proc_terminate($this->process);
+        }
+    }
+
+    public function isRunning(): bool {
+        return $this->process !== null && $this->exitCode === null;
+    }
+
+    public function isCancelled(): bool {
+        return $this->cancelledAt !== null;
+    }
+
+    public function isTimedOut(): bool {
+        return $this->timedOut;
+    }
+
+    public function getExitCode(): ?int {
+        return $this->exitCode;
+    }
+
+    public function getCommandLine(): string {
+        return is_array($this->command) ? implode(' ', array_map('escapeshellarg', $this->command)) : $this->command;
+    }
+
+    /**
+     * 同步等待进程结束（用于没有主循环的脚本）
+     */
+    public function wait(): int {
+        while ($this->isRunning()) {
+            $this->pump();
+            if ($this->isRunning()) {
+                usleep(self::POLL_INTERVAL * 1000);
+            }
+        }
+        return $this->exitCode;
+    }
+
+    /**
+     * 定时器回调：轮询所有运行中的进程
+     */
+    public static function poll(): bool {
+        foreach (self::$running as $process) {
+            // 回调抛出的异常不能中断轮询，否则之后启动的进程都不会再被读取
+            try {
+                $process->pump();
+            } catch (\Throwable $e) {
+                LibuiApplication::getInstance()->getLogger()->error("Process callback error", [
+                    'command' => $process->getCommandLine(),
+                    'error' => $e->getMessage(),
+                ]);
+            }
+        }
+        if (empty(self::$running)) {
+            self::$polling = false;
+            return false;
+        }
+        return true;
+    }
+
+    private static function ensurePolling(): void {
+        // 没有初始化 libui 的命令行脚本没有主循环，由 wait() 轮询
+        if (!self::$polling && LibuiApplication::getInstance()->isInitialized()) {
+            self::$polling = true;
+            LibuiApplication::getInstance()->timer(self::POLL_INTERVAL, [self::class, 'poll']);
+        }
+    }
+
+    /**
+     * 读取当前可读的输出，并检查进程是否结束
+     */
+    private function pump(): void {
+        if (!$this->isRunning()) {
+            return;
+        }
+
+        $this->readAvailable();
+
+        $status = proc_get_status($this->process);
+        if (!$status['running']) {
+            // exitcode 只在第一次检测到进程结束时有效
+            $exitCode = $status['signaled'] ? 128 + $status['termsig'] : $status['exitcode'];
+            $this->drain();
+            $this->finish($exitCode);
+            return;
+        }
+
+        $now = microtime(true);
+        if ($this->timeout > 0 && $this->cancelledAt === null && $now - $this->startedAt > $this->timeout) {
+            $this->timedOut = true;
+            $this->cancel();
+        } elseif ($this->cancelledAt !== null && $now - $this->cancelledAt > self::KILL_GRACE) {
+            proc_terminate($this->process, 9);
+        }
+    }
+
+    private function readAvailable(): void {
+        if (PHP_OS_FAMILY === 'Windows') {
+            foreach ($this->streams as $name => $stream) {
+                $this->feed($name, (string)fread($stream, self::READ_BUDGET));
+            }
+            return;
+        }
+
+        $read = array_values($this->streams);
+        if (empty($read)) {
+            return;
+        }
+        $write = null;
+        $except = null;
+        if (@stream_select($read, $write, $except, 0) > 0) {
+            foreach ($read as $stream) {
+                $name = array_search($stream, $this->streams, true);
+                $data = fread($stream, self::READ_BUDGET);
+                if (($data === false || $data === '') && feof($stream)) {
+                    fclose($stream);
+                    unset($this->streams[$name]);
+                    continue;
+                }
+                $this->feed($name, (string)$data);
+            }
+        }
+    }
+
+    /**
+     * 进程结束后读取剩余输出
+     */
+    private function drain(): void {
+        foreach ($this->streams as $name => $stream) {
+            while (($data = fread($stream, self::READ_BUDGET)) !== false && $data !== '') {
+                $this->feed($name, $data);
+            }
+            fclose($stream);
+        }
+        $this->streams = [];
+        foreach ($this->buffers as $name => $buffer) {
+            if ($buffer !== '') {
+                $this->buffers[$name] = '';
+                $this->dispatch(rtrim($buffer, "\r"), $name);
+            }
+        }
+    }
+
+    /**
+     * 按行切分输出，不完整的行留在缓冲区等待后续数据
+     */
+    private function feed(string $stream, string $data): void {
+        if ($data === '') {
+            return;
+        }
+        $buffer = $this->buffers[$stream] . $data;
+        $end = strrpos($buffer, "\n");
+        if ($end === false) {
+            if (strlen($buffer) >= self::MAX_LINE_LENGTH) {
+                $this->buffers[$stream] = '';
+                $this->dispatch($buffer, $stream);
+            } else {
+                $this->buffers[$stream] = $buffer;
+            }
+            return;
+        }
+        $this->buffers[$stream] = (string)substr($buffer, $end + 1);
+        foreach (explode("\n", substr($buffer, 0, $end)) as $line) {
+            $this->dispatch(rtrim($line, "\r"), $stream);
+        }
+    }
+
+    private function dispatch(string $line, string $stream): void {
+        foreach ($this->lineCallbacks as $callback) {
+            $callback($line, $stream, $this);
+        }
+    }
+
+    private function finish(int $exitCode): void {
+        $this->exitCode = $exitCode;
+        proc_close($this->process);
+        $this->removeTempFiles();
+        unset(self::$running[spl_object_id($this)]);
+
+        foreach ($this->exitCallbacks as $callback) {
+            $callback($exitCode, $this);
+        }
+    }
+
+    private function removeTempFiles(): void {
+        foreach ($this->tempFiles as $file) {
+            @unlink($file);
+        }
+        $this->tempFiles = [];
+    }
+}
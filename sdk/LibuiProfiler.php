@@ -0,0 +1,340 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+use Kingbes\Libui\Base;
+use Psr\Log\LoggerInterface;
+use Psr\Log\NullLogger;
+
+/**
+ * 主线程回调性能分析器（默认关闭）
+ *
+ * 启用后，SDK 在注册 FFI 回调、事件监听、queueMain 和定时器时用 wrap() 包装回调，
+ * 记录每次调用的耗时、经由 Base::ffi() 的 FFI 调用次数和内存变化：
+ * - 最近的调用保存在固定大小的环形缓冲中，可以导出为 Chrome trace-event JSON（chrome://tracing、Perfetto）
+ * - 每个回调按耗时累计对数直方图，不受环形缓冲大小限制
+ * - 耗时超过阈值的调用视为阻塞主循环，记录到慢调用列表并输出警告日志
+ *
+ * 只有启用后注册的回调会被计时，所以需要在创建界面之前调用 LibuiApplication::enableProfiler()。
+ * 未启用时 wrap() 原样返回回调，没有额外开销。
+ */
+class LibuiProfiler
+{
+    // 直方图桶数：第 i 个桶为 [2^i, 2^(i+1)) 微秒，第 0 个桶包含 2 微秒以下，最后一个桶包含更长的调用
+    public const BUCKETS = 20;
+
+    private const MAX_SLOW = 100;
+
+    private static int $enabledCount = 0; // 已开启的分析器数量，有开启的分析器时才统计 FFI 调用
+    private bool $enabled = false;
+    private float $thresholdMs = 16.0;
+    private int $capacity = 4096;
+    private array $samples = []; // 环形缓冲：[名称, 类别, 开始 ns, 耗时 ns, FFI 调用数, 内存变化字节]
+    private int $head = 0;
+    private array $stats = [];
+    private array $slow = [];
+    private int $slowCount = 0;
+    private array $slowListeners = [];
+    private int $origin;
+    private ?LoggerInterface $logger = null;
+
+    public function __construct() {
+        $this->origin = hrtime(true);
+    }
+
+    /**
+     * @param float $thresholdMs 超过该耗时的调用视为阻塞主循环（默认一帧 16ms）
+     * @param int $capacity 环形缓冲保存的调用数
+     */
+    public function enable(float $thresholdMs = 16.0, int $capacity = 4096): self {
+        if (!$this->enabled) {
+            Base::setCallCounting(++self::$enabledCount > 0);
+        }
+        $this->enabled = true;
+        $this->thresholdMs = $thresholdMs;
+        if ($capacity !== $this->capacity) {
+            $this->capacity = max(1, $capacity);
+            $this->samples = [];
+            $this->head = 0;
+        }
+        return $this;
+    }
+
+    /**
+     * 停止为新注册的回调计时，已包装的回调继续记录
+     */
+    public function disable(): self {
+        if ($this->enabled) {
+            Base::setCallCounting(--self::$enabledCount > 0);
+        }
+        $this->enabled = false;
+        return $this;
+    }
+
+    public function isEnabled(): bool {
+        return $this->enabled;
+    }
+
+    public function setThreshold(float $thresholdMs): self {
+        $this->thresholdMs = $thresholdMs;
+        return $this;
+    }
+
+    public function getThreshold(): float {
+        return $this->thresholdMs;
+    }
+
+    public function setLogger(LoggerInterface $logger): self {
+        $this->logger = $logger;
+        return $this;
+    }
+
+    /**
+     * 注册慢调用回调：function(string $name, float $ms, string $category)
+     */
+    public function onSlow(callable $callback): self {
+        $this->slowListeners[] = $callback;
+        return $this;
+    }
+
+    /**
+     * 返回计时的回调；未启用时原样返回
+     *
+     * @param bool $trace 是否写入环形缓冲（每个单元格都会调用的 CellValue 等只计入直方图，避免冲掉其他记录）
+     */
+    public function wrap(string $name, callable $callback, string $category = 'callback', bool $trace = true): callable {
+        if (!$this->enabled) {
+            return $callback;
+        }
+        return function (...$args) use ($name, $callback, $category, $trace) {
+            $calls = Base::getCallCount();
+            $memory = memory_get_usage();
+            $start = hrtime(true);
+            try {
+                return $callback(...$args);
+            } finally {
+                $this->record($name, $category, $start, hrtime(true) - $start, Base::getCallCount() - $calls, memory_get_usage() - $memory, $trace);
+            }
+        };
+    }
+
+    /**
+     * 记录一次调用
+     */
+    public function record(string $name, string $category, int $start, int $durationNs, int $ffiCalls = 0, int $memory = 0, bool $trace = true): void {
+        $us = intdiv($durationNs, 1000);
+        $bucket = $us < 2 ? 0 : min(self::BUCKETS - 1, strlen(decbin($us)) - 1);
+
+        if (!isset($this->stats[$name])) {
+            $this->stats[$name] = [
+                'category' => $category,
+                'count' => 0,
+                'total_ns' => 0,
+                'max_ns' => 0,
+                'ffi_calls' => 0,
+                'memory' => 0,
+                'slow' => 0,
+                'buckets' => array_fill(0, self::BUCKETS, 0),
+            ];
+        }
+        $stat = &$this->stats[$name];
+        $stat['count']++;
+        $stat['total_ns'] += $durationNs;
+        $stat['max_ns'] = max($stat['max_ns'], $durationNs);
+        $stat['ffi_calls'] += $ffiCalls;
+        $stat['memory'] += $memory;
+        $stat['buckets'][$bucket]++;
+
+        if ($trace) {
+            $this->samples[$this->head] = [$name, $category, $start, $durationNs, $ffiCalls, $memory];
+            $this->head = ($this->head + 1) % $this->capacity;
+        }
+
+        $ms = $durationNs / 1e6;
+        if ($ms > $this->thresholdMs) {
+            $stat['slow']++;
+            $this->flagSlow($name, $category, $ms);
+        }
+    }
+
+    private function flagSlow(string $name, string $category, float $ms): void {
+        $this->slowCount++;
+        $this->slow[] = ['name' => $name, 'category' => $category, 'ms' => $ms, 'time' => microtime(true)];
+        if (count($this->slow) > self::MAX_SLOW) {
+            array_shift($this->slow);
+        }
+
+        $this->getLogger()->warning("Callback blocked the main loop", [
+            'callback' => $name,
+            'category' => $category,
+            'ms' => round($ms, 2),
+            'threshold_ms' => $this->thresholdMs
+        ]);
+        foreach ($this->slowListeners as $listener) {
+            $listener($name, $ms, $category);
+        }
+    }
+
+    private function getLogger(): LoggerInterface {
+        if ($this->logger === null) {
+            try {
+                $this->logger = LibuiApplication::getInstance()->getLogger();
+            } catch (\Throwable $e) {
+                $this->logger = new NullLogger();
+            }
+        }
+        return $this->logger;
+    }
+
+    /**
+     * 按时间顺序返回环形缓冲中的调用
+     */
+    public function getSamples(): array {
+        if (count($this->samples) < $this->capacity) {
+            return $this->samples;
+        }
+        return array_merge(array_slice($this->samples, $this->head), array_slice($this->samples, 0, $this->head));
+    }
+
+    /**
+     * 每个回调的汇总，按总耗时从高到低排序
+     *
+     * 每项包含 name、category、count、total_ms、avg_ms、max_ms、p95_ms（按直方图桶上界估算）、
+     * ffi_calls（平均每次）、memory（平均每次的字节数）、slow、buckets
+     */
+    public function getStats(): array {
+        $result = [];
+        foreach ($this->stats as $name => $stat) {
+            $result[] = [
+                'name' => $name,
+                'category' => $stat['category'],
+                'count' => $stat['count'],
+                'total_ms' => $stat['total_ns'] / 1e6,
+                'avg_ms' => $stat['total_ns'] / $stat['count'] / 1e6,
+                'max_ms' => $stat['max_ns'] / 1e6,
+                'p95_ms' => min($stat['max_ns'] / 1e6, self::percentile($stat['buckets'], 0.95)),
+                'ffi_calls' => $stat['ffi_calls'] / $stat['count'],
+                'memory' => $stat['memory'] / $stat['count'],
+                'slow' => $stat['slow'],
+                'buckets' => $stat['buckets'],
+            ];
+        }
+        usort($result, fn($a, $b) => $b['total_ms'] <=> $a['total_ms']);
+        return $result;
+    }
+
+    /**
+     * 最近的慢调用（最多 100 条）
+     */
+    public function getSlowCalls(): array {
+        return $this->slow;
+    }
+
+    public function getSlowCount(): int {
+        return $this->slowCount;
+    }
+
+    /**
+     * 所有回调合并后的直方图
+     */
+    public function getHistogram(?string $name = null): array {
+        if ($name !== null) {
+            return $this->stats[$name]['buckets'] ?? array_fill(0, self::BUCKETS, 0);
+        }
+        $buckets = array_fill(0, self::BUCKETS, 0);
+        foreach ($this->stats as $stat) {
+            foreach ($stat['buckets'] as $i => $count) {
+                $buckets[$i] += $count;
+            }
+        }
+        return $buckets;
+    }
+
+    /**
+     * 直方图第 $bucket 个桶的上界（毫秒）
+     */
+    public static function bucketUpperMs(int $bucket): float {
+        return (2 ** ($bucket + 1)) / 1000;
+    }
+
+    private static function percentile(array $buckets, float $fraction): float {
+        $target = array_sum($buckets) * $fraction;
+        $seen = 0;
+        foreach ($buckets as $i => $count) {
+            $seen += $count;
+            if ($seen >= $target) {
+                return self::bucketUpperMs($i);
+            }
+        }
+        return self::bucketUpperMs(self::BUCKETS - 1);
+    }
+
+    public function clear(): void {
+        $this->samples = [];
+        $this->head = 0;
+        $this->stats = [];
+        $this->slow = [];
+        $this->slowCount = 0;
+    }
+
+    /**
+     * 环形缓冲中的调用转换为 Chrome trace-event 格式
+     */
+    public function toChromeTrace(): array {
+        $pid = getmypid() ?: 1;
+        $events = [
+            ['name' => 'process_name', 'ph' => 'M', 'pid' => $pid, 'tid' => 1, 'args' => ['name' => 'php-tools']],
+            ['name' => 'thread_name', 'ph' => 'M', 'pid' => $pid, 'tid' => 1, 'args' => ['name' => 'main loop']],
+        ];
+        foreach ($this->getSamples() as [$name, $category, $start, $durationNs, $ffiCalls, $memory]) {
+            $event = [
+                'name' => $name,
+                'cat' => $category,
+                'ph' => 'X',
+                'ts' => ($start - $this->origin) / 1000,
+                'dur' => $durationNs / 1000,
+                'pid' => $pid,
+                'tid' => 1,
+                'args' => ['ffi_calls' => $ffiCalls, 'memory_bytes' => $memory],
+            ];
+            if ($durationNs / 1e6 > $this->thresholdMs) {
+                $event['args']['slow'] = true;
+            }
+            $events[] = $event;
+        }
+        return ['traceEvents' => $events, 'displayTimeUnit' => 'ms'];
+    }
+
+    /**
+     * 导出 Chrome trace-event JSON，返回文件路径
+     */
+    public function exportChromeTrace(string $file): string {
+        $json = json_encode($this->toChromeTrace(), JSON_UNESCAPED_UNICODE | JSON_UNESCAPED_SLASHES | JSON_INVALID_UTF8_SUBSTITUTE);
+        if ($json === false || file_put_contents($file, $json) === false) {
+            throw new \RuntimeException("Failed to write trace file: $file");
+        }
+        return $file;
+    }
+
+    /**
+     * 用于显示的回调名称：闭包为 文件名:行号，数组回调为 类名::方法名
+     */
+    public static function describe(callable $callback): string {
+        try {
+            if (is_array($callback)) {
+                $class = is_object($callback[0]) ? $callback[0]::class : $callback[0];
+                return substr(strrchr('\\' . $class, '\\'), 1) . '::' . $callback[1];
+            }
+            if (is_string($callback)) {
+                return $callback;
+            }
+            $reflection = new \ReflectionFunction(\Closure::fromCallable($callback));
+            if ($reflection->getFileName() === false) {
+                return $reflection->getName();
+            }
+            return basename($reflection->getFileName()) . ':' . $reflection->getStartLine();
+        } catch (\Throwable $e) {
+            return 'callback';
+        }
+    }
+}
@@ -0,0 +1,149 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 保留模式的显示列表
+ *
+ * 节点按添加顺序绘制。路径、画刷和描边参数创建后一直复用，只有内容变化的节点才重新生成路径；
+ * 与本次裁剪区域（滚动区域中即可见部分）不相交的节点直接跳过。
+ * libui 的每次 Draw 都会重绘整个裁剪区域，所以可见节点仍会全部重放，但重放只是几次 FFI 调用。
+ *
+ * 用法：
+ *   $scene = new LibuiScene();
+ *   $scene->add((new LibuiSceneNode())->rectangle(0, 0, 100, 50)->setFill(1, 0, 0));
+ *   $area->setScene($scene);
+ */
+class LibuiScene
+{
+    private array $nodes = [];
+    private array $listeners = [];
+    private LibuiDrawCache $cache;
+    private int $nextId = 0;
+    private bool $culling = true;
+    private int $rebuilt = 0;
+    private array $stats = ['frames' => 0, 'rendered' => 0, 'culled' => 0, 'rebuilt' => 0, 'ms' => 0.0];
+
+    public function __construct(?LibuiDrawCache $cache = null) {
+        $this->cache = $cache ?? new LibuiDrawCache();
+    }
+
+    /**
+     * 添加节点，返回节点 ID
+     */
+    public function add(LibuiSceneNode $node, ?string $id = null): string {
+        $id ??= 'node' . $this->nextId++;
+        if (isset($this->nodes[$id])) {
+            $this->nodes[$id]->attach(null);
+        }
+        $this->nodes[$id] = $node;
+        $node->attach($this);
+        $this->invalidate();
+        return $id;
+    }
+
+    public function remove(string $id): void {
+        if (isset($this->nodes[$id])) {
+            $this->nodes[$id]->attach(null);
+            unset($this->nodes[$id]);
+            $this->invalidate();
+        }
+    }
+
+    public function get(string $id): ?LibuiSceneNode {
+        return $this->nodes[$id] ?? null;
+    }
+
+    public function clear(): void {
+        foreach ($this->nodes as $node) {
+            $node->attach(null);
+        }
+        $this->nodes = [];
+        $this->invalidate();
+    }
+
+    public function count(): int {
+        return count($this->nodes);
+    }
+
+    public function getCache(): LibuiDrawCache {
+        return $this->cache;
+    }
+
+    public function setCulling(bool $culling): self {
+        $this->culling = $culling;
+        return $this;
+    }
+
+    /**
+     * 注册场景变化回调（LibuiDrawArea 用它合并重绘请求）
+     */
+    public function onInvalidate(callable $callback): self {
+        $this->listeners[] = $callback;
+        return $this;
+    }
+
+    /**
+     * 移除 onInvalidate 注册的回调（按同一个闭包对象匹配）
+     */
+    public function offInvalidate(callable $callback): self {
+        $this->listeners = array_values(array_filter($this->listeners, fn($listener) => $listener !== $callback));
+        return $this;
+    }
+
+    public function invalidate(): void {
+        foreach ($this->listeners as $listener) {
+            $listener($this);
+        }
+    }
+
+    /**
+     * 由自己持有路径的节点在重新生成路径时调用，用于统计
+     */
+    public function countRebuild(): void {
+        $this->rebuilt++;
+    }
+
+    public function render(LibuiDrawContext $context): void {
+        $start = hrtime(true);
+        $missesBefore = $this->cache->getStats()['misses'];
+        $this->rebuilt = 0;
+        $rendered = $culled = 0;
+
+        [$clipX, $clipY, $clipWidth, $clipHeight] = $context->getClip();
+        // 部分平台给出的裁剪区域为空，此时绘制全部节点
+        $cull = $this->culling && $clipWidth > 0 && $clipHeight > 0;
+        $clipRight = $clipX + $clipWidth;
+        $clipBottom = $clipY + $clipHeight;
+
+        foreach ($this->nodes as $node) {
+            if (!$node->isVisible()) {
+                continue;
+            }
+            if ($cull) {
+                [$minX, $minY, $maxX, $maxY] = $node->getBounds();
+                if ($maxX < $clipX || $minX > $clipRight || $maxY < $clipY || $minY > $clipBottom) {
+                    $culled++;
+                    continue;
+                }
+            }
+            $node->render($context, $this->cache);
+            $rendered++;
+        }
+
+        $this->stats = [
+            'frames' => $this->stats['frames'] + 1,
+            'rendered' => $rendered,
+            'culled' => $culled,
+            'rebuilt' => $this->rebuilt + $this->cache->getStats()['misses'] - $missesBefore,
+            'ms' => (hrtime(true) - $start) / 1e6,
+        ];
+    }
+
+    /**
+     * 最近一帧的统计：frames（累计帧数）、rendered、culled、rebuilt（重新生成的路径数）、ms
+     */
+    public function getStats(): array {
+        return $this->stats;
+    }
+}
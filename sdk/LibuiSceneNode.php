@@ -0,0 +1,197 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 显示列表节点
+ *
+ * 路径命令只记录一次，绘制时按内容键从 LibuiDrawCache 取出已创建的路径；
+ * 只有命令变化后才会重新生成路径，修改颜色等样式不需要重新生成。
+ */
+class LibuiSceneNode
+{
+    protected array $commands = [];
+    protected ?array $fill = null;   // [r, g, b, a]
+    protected ?array $stroke = null; // [r, g, b, a, 线宽]
+    protected bool $visible = true;
+    protected ?LibuiScene $scene = null;
+
+    private ?string $key = null;
+    private ?array $bounds = null;
+
+    public function newFigure(float $x, float $y): self {
+        $this->commands[] = ['newFigure', $x, $y];
+        return $this->changed();
+    }
+
+    public function lineTo(float $x, float $y): self {
+        $this->commands[] = ['lineTo', $x, $y];
+        return $this->changed();
+    }
+
+    public function rectangle(float $x, float $y, float $width, float $height): self {
+        $this->commands[] = ['rectangle', $x, $y, $width, $height];
+        return $this->changed();
+    }
+
+    public function newFigureWithArc(float $xCenter, float $yCenter, float $radius, float $startAngle, float $sweep, bool $negative = false): self {
+        $this->commands[] = ['newFigureWithArc', $xCenter, $yCenter, $radius, $startAngle, $sweep, $negative];
+        return $this->changed();
+    }
+
+    public function arcTo(float $xCenter, float $yCenter, float $radius, float $startAngle, float $sweep, bool $negative = false): self {
+        $this->commands[] = ['arcTo', $xCenter, $yCenter, $radius, $startAngle, $sweep, $negative];
+        return $this->changed();
+    }
+
+    public function bezierTo(float $c1x, float $c1y, float $c2x, float $c2y, float $endX, float $endY): self {
+        $this->commands[] = ['bezierTo', $c1x, $c1y, $c2x, $c2y, $endX, $endY];
+        return $this->changed();
+    }
+
+    public function closeFigure(): self {
+        $this->commands[] = ['closeFigure'];
+        return $this->changed();
+    }
+
+    /**
+     * 清除已记录的路径命令
+     */
+    public function clear(): self {
+        $this->commands = [];
+        return $this->changed();
+    }
+
+    public function setFill(float $r, float $g, float $b, float $a = 1.0): self {
+        $this->fill = [$r, $g, $b, $a];
+        return $this->restyled();
+    }
+
+    public function setStroke(float $r, float $g, float $b, float $a = 1.0, float $thickness = 1.0): self {
+        $this->stroke = [$r, $g, $b, $a, $thickness];
+        $this->bounds = null;
+        return $this->restyled();
+    }
+
+    public function removeFill(): self {
+        $this->fill = null;
+        return $this->restyled();
+    }
+
+    public function removeStroke(): self {
+        $this->stroke = null;
+        return $this->restyled();
+    }
+
+    public function setVisible(bool $visible): self {
+        $this->visible = $visible;
+        return $this->restyled();
+    }
+
+    public function isVisible(): bool {
+        return $this->visible;
+    }
+
+    /**
+     * 由 LibuiScene 在添加/移除节点时调用
+     */
+    public function attach(?LibuiScene $scene): void {
+        $this->scene = $scene;
+    }
+
+    /**
+     * 包围盒 [minX, minY, maxX, maxY]，已包含描边宽度，用于视口裁剪
+     */
+    public function getBounds(): array {
+        if ($this->bounds !== null) {
+            return $this->bounds;
+        }
+
+        $minX = $minY = INF;
+        $maxX = $maxY = -INF;
+        foreach ($this->commands as $command) {
+            switch ($command[0]) {
+                case 'newFigure':
+                case 'lineTo':
+                    $points = [[$command[1], $command[2]]];
+                    break;
+                case 'rectangle':
+                    $points = [[$command[1], $command[2]], [$command[1] + $command[3], $command[2] + $command[4]]];
+                    break;
+                case 'newFigureWithArc':
+                case 'arcTo':
+                    // 按整个圆估算
+                    $points = [[$command[1] - $command[3], $command[2] - $command[3]], [$command[1] + $command[3], $command[2] + $command[3]]];
+                    break;
+                case 'bezierTo':
+                    // 曲线位于控制点的凸包内
+                    $points = [[$command[1], $command[2]], [$command[3], $command[4]], [$command[5], $command[6]]];
+                    break;
+                default:
+                    $points = [];
+            }
+            foreach ($points as [$x, $y]) {
+                $minX = min($minX, $x);
+                $minY = min($minY, $y);
+                $maxX = max($maxX, $x);
+                $maxY = max($maxY, $y);
+            }
+        }
+
+        $margin = $this->stroke !== null ? $this->stroke[4] / 2 : 0.0;
+        return $this->bounds = [$minX - $margin, $minY - $margin, $maxX + $margin, $maxY + $margin];
+    }
+
+    /**
+     * 路径内容键，命令不变时不重新计算
+     */
+    public function getKey(): string {
+        return $this->key ??= md5(serialize($this->commands));
+    }
+
+    /**
+     * 把记录的命令写入路径
+     */
+    public function buildPath(LibuiPath $path): void {
+        foreach ($this->commands as $command) {
+            $method = array_shift($command);
+            $path->$method(...$command);
+        }
+    }
+
+    public function render(LibuiDrawContext $context, LibuiDrawCache $cache): void {
+        if (empty($this->commands)) {
+            return;
+        }
+        $path = $cache->path($this->getKey(), fn(LibuiPath $path) => $this->buildPath($path));
+        $this->paint($context, $cache, $path);
+    }
+
+    protected function paint(LibuiDrawContext $context, LibuiDrawCache $cache, LibuiPath $path): void {
+        if ($this->fill !== null) {
+            $context->fill($path, $cache->brush(...$this->fill));
+        }
+        if ($this->stroke !== null) {
+            [$r, $g, $b, $a, $thickness] = $this->stroke;
+            $context->stroke($path, $cache->brush($r, $g, $b, $a), $cache->stroke($thickness));
+        }
+    }
+
+    /**
+     * 路径命令变化：丢弃内容键和包围盒，通知场景重绘
+     */
+    protected function changed(): self {
+        $this->key = null;
+        $this->bounds = null;
+        $this->scene?->invalidate();
+        return $this;
+    }
+
+    /**
+     * 只有样式变化：路径可以继续使用
+     */
+    protected function restyled(): self {
+        $this->scene?->invalidate();
+        return $this;
+    }
+}
@@ -30,4 +30,14 @@ class LibuiStrokeParams
         $this->handle->Thickness = $thickness;
         return $this;
     }
+
+    public function setCap(DrawLineCap $cap): self {
+        $this->handle->Cap = $cap->value;
+        return $this;
+    }
+
+    public function setJoin(DrawLineJoin $join): self {
+        $this->handle->Join = $join->value;
+        return $this;
+    }
 }
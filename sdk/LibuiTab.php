@@ -12,6 +12,8 @@ use Kingbes\Libui\Control;
 class LibuiTab extends LibuiComponent
 {
     private array $tabs = []; // 保存标签页引用
+    private array $lazyPages = []; // 索引 => [占位容器, 创建函数]
+    private bool $selectionHooked = false;
 
     public function __construct() {
         parent::__construct();
@@ -67,8 +69,58 @@ class LibuiTab extends LibuiComponent
         // 保存标签页回调函数
         if ($callback) {
             $this->tabs[$index] = $callback;
+            $this->hookSelection();
         }
         
         return $this;
     }
+
+    /**
+     * 添加延迟创建的标签页
+     *
+     * 先放入一个空容器，第一次选中该标签页时才调用 $factory 创建内容（返回 LibuiComponent 或 CData）。
+     * 第一个标签页启动时就可见，会立即创建。
+     */
+    public function appendLazy(string $name, callable $factory): self {
+        $index = Tab::numPages($this->handle);
+        $placeholder = new LibuiVBox();
+        $this->append($name, $placeholder);
+
+        if ($index === 0) {
+            $placeholder->append($factory(), true);
+            return $this;
+        }
+
+        $this->lazyPages[$index] = [$placeholder, $factory];
+        $this->hookSelection();
+
+        return $this;
+    }
+
+    /**
+     * 创建尚未创建的标签页内容
+     */
+    public function buildPage(int $index): void {
+        if (!isset($this->lazyPages[$index])) {
+            return;
+        }
+        [$placeholder, $factory] = $this->lazyPages[$index];
+        unset($this->lazyPages[$index]);
+        $placeholder->append($factory(), true);
+    }
+
+    private function hookSelection(): void {
+        if ($this->selectionHooked) {
+            return;
+        }
+        $this->selectionHooked = true;
+
+        Tab::onSelected($this->handle, function () {
+            $index = Tab::selected($this->handle);
+            $this->buildPage($index);
+            if (isset($this->tabs[$index])) {
+                ($this->tabs[$index])($index);
+            }
+        });
+    }
 }
\ No newline at end of file
@@ -6,24 +6,35 @@ use FFI\CData;
 use Kingbes\Libui\Base;
 use Kingbes\Libui\Table;
 use Kingbes\Libui\TableValueType;
+use RuntimeException;
 
 /**
  * 表格组件
+ *
+ * 数据默认保存在列式存储 ColumnarTableData 中，也可以通过 setDataSource()
+ * 接入任意 LibuiTableDataSource（例如按需加载的 LazyTableDataSource）。
  */
 class LibuiTable extends LibuiComponent
 {
     private array $columns = [];
-    private array $data = [];
     private array $columnTypes = [];
-    private int $initialColumnCount = 0;
-    private int $initialRowCount = 0;
+    private ColumnarTableData $store;
+    private LibuiTableDataSource $source;
+    private array $cellFactories = []; // 列号 => 创建 uiTableValue 的闭包，添加列时确定
+    private array $valueTypes = [];    // 列号 => TableValueType 值
+    private $defaultCellFactory = null;
+    private int $columnCount = 0;
+    private int $rowCount = 0;         // 已通知给 libui 的行数，NumRows 回调返回此值
     private ?CData $model = null;
     private ?CData $modelHandler = null;
 
     public function __construct() {
         parent::__construct();
+        $this->store = new ColumnarTableData();
+        $this->source = $this->store;
         // 不在构造函数中创建handle，而是在需要时延迟创建
         $this->handle = null;
+        $this->resolveColumnTypes();
     }
     
     public function getHandle(): CData {
@@ -34,109 +45,11 @@ class LibuiTable extends LibuiComponent
     }
 
     protected function createHandle(): CData {
-        // 初始化行列计数
-        $this->initialColumnCount = 0;
-        $this->initialRowCount = 0;
-        
-        // 计算实际的行列数
-        if (!empty($this->data)) {
-            $this->initialRowCount = count($this->data);
-            foreach ($this->data as $row) {
-                $this->initialColumnCount = max($this->initialColumnCount, count($row));
-            }
-        }
-        
-        // 确保列数至少等于已定义列的最大索引+1
-        foreach ($this->columns as $column) {
-            $this->initialColumnCount = max($this->initialColumnCount, $column['index'] + 1);
-        }
-        
-        // 确保至少有1列，行数可以为0（空表格）
-        $this->initialColumnCount = max(1, $this->initialColumnCount);
-        // 不再强制至少1行，允许0行的空表格
-        $this->initialRowCount = $this->initialRowCount;
-
-        // 确定列类型 - 如果有任何checkbox列，使用Int类型，否则使用String类型
-        $columnType = TableValueType::String;
-        foreach ($this->columnTypes as $type) {
-            if ($type === 'checkbox') {
-                $columnType = TableValueType::Int;
-                break;
-            }
-        }
-
-        // 创建表格模型处理程序
-        $this->modelHandler = Table::modelHandler(
-            $this->initialColumnCount, // 列数
-            $columnType, // 列类型
-            $this->initialRowCount, // 行数
-            function ($handler, $row, $column) {
-                try {
-                    // 确保行和列存在
-                    if (!isset($this->data[$row][$column])) {
-                        // 根据列类型返回默认值
-                        if (isset($this->columnTypes[$column]) && $this->columnTypes[$column] === 'checkbox') {
-                            return Table::createValueInt(0);
-                        } else {
-                            return Table::createValueStr('');
-                        }
-                    }
-                    
-                    // 根据列类型返回相应的值
-                    if (isset($this->columnTypes[$column]) && $this->columnTypes[$column] === 'checkbox') {
-                        $value = $this->data[$row][$column] ?? 0;
-                        return Table::createValueInt((int)$value);
-                    } else {
-                        $value = $this->data[$row][$column] ?? '';
-                        return Table::createValueStr((string)$value);
-                    }
-                } catch (\Throwable $e) {
-                    // 在回调函数中不能抛出异常，返回默认值
-                    if (isset($this->columnTypes[$column]) && $this->columnTypes[$column] === 'checkbox') {
-                        return Table::createValueInt(0);
-                    } else {
-                        return Table::createValueStr('');
-                    }
-                }
-            },
-            function ($handler, $row, $column, $value) {
-                try {
-                    error_log("SetCellValue called: row=$row, column=$column");
-                    // 设置单元格值
-                    if (!isset($this->data[$row])) {
-                        $this->data[$row] = [];
-                    }
-                    
-                    $oldValue = null;
-                    if (isset($this->data[$row][$column])) {
-                        $oldValue = $this->data[$row][$column];
-                    }
-                    
-                    if (isset($this->columnTypes[$column]) && $this->columnTypes[$column] === 'checkbox') {
-                        $this->data[$row][$column] = Table::valueInt($value);
-                        error_log("Set checkbox value: row=$row, column=$column, old=$oldValue, new=".$this->data[$row][$column]);
-                    } else {
-                        $this->data[$row][$column] = Table::valueStr($value);
-                    }
-                    
-                    // 如果是复选框列且值发生了变化，触发事件
-                    if (isset($this->columnTypes[$column]) && $this->columnTypes[$column] === 'checkbox' && $oldValue !== $this->data[$row][$column]) {
-                        error_log("Emitting checkbox changed event: row=$row, column=$column, old=$oldValue, new=".$this->data[$row][$column]);
-                        $this->emit('table.checkbox_changed', [
-                            'row' => $row,
-                            'column' => $column,
-                            'old_value' => $oldValue,
-                            'new_value' => $this->data[$row][$column]
-                        ]);
-                    }
-                } catch (\Throwable $e) {
-                    error_log("SetCellValue error: " . $e->getMessage());
-                    // 在回调函数中不能抛出异常，静默处理
-                }
-            }
-        );
+        $this->resolveColumnTypes();
+        $this->rowCount = $this->source->getRowCount();
 
         // 创建表格模型
+        $this->modelHandler = $this->createModelHandler();
         $this->model = Table::createModel($this->modelHandler);
 
         // 创建表格
@@ -161,99 +74,260 @@ class LibuiTable extends LibuiComponent
         return $table;
     }
 
+    /**
+     * 创建表格模型处理程序
+     *
+     * Table::modelHandler 的 NumRows 固定返回创建时的行数，这里改为返回当前行数，
+     * 行的插入、删除通知才能和 libui 看到的行数保持一致。
+     * 启用性能分析时，每个单元格都会调用的回调只计入直方图，不写入调用记录。
+     */
+    private function createModelHandler(): CData {
+        $handler = Table::ffi()->new("uiTableModelHandler");
+        $handler->NumColumns = $this->profiler->wrap('table.NumColumns', function ($h, $m) {
+            return $this->columnCount;
+        }, 'table', false);
+        $handler->ColumnType = $this->profiler->wrap('table.ColumnType', function ($h, $m, $column) {
+            return $this->valueTypes[$column] ?? TableValueType::String->value;
+        }, 'table', false);
+        $handler->NumRows = $this->profiler->wrap('table.NumRows', function ($h, $m) {
+            return $this->rowCount;
+        }, 'table', false);
+        $handler->CellValue = $this->profiler->wrap('table.CellValue', function ($h, $m, $row, $column) {
+            return $this->cellValue($row, $column);
+        }, 'table', false);
+        $handler->SetCellValue = $this->profiler->wrap('table.SetCellValue', function ($h, $m, $row, $column, $value) {
+            $this->setCellValue($row, $column, $value);
+        }, 'table');
+        return $handler;
+    }
+
+    /**
+     * 根据已添加的列确定每一列的值类型和取值闭包
+     *
+     * 绘制时每个单元格只做一次数组查找，不再逐个判断列类型。
+     * 注意：libui 会在使用后释放 CellValue 返回的 uiTableValue，所以句柄本身不能缓存复用。
+     * 取值闭包直接使用缓存的 FFI 实例，不经过 Base::ffi()；性能分析开启时换成自己计数的版本。
+     */
+    private function resolveColumnTypes(): void {
+        $ffi = Table::ffi();
+        if (Base::isCallCounting()) {
+            $intValue = static function ($value) use ($ffi) {
+                Base::addCall();
+                return $ffi->uiNewTableValueInt((int)$value);
+            };
+            $stringValue = static function ($value) use ($ffi) {
+                Base::addCall();
+                return $ffi->uiNewTableValueString((string)$value);
+            };
+        } else {
+            $intValue = static function ($value) use ($ffi) {
+                return $ffi->uiNewTableValueInt((int)$value);
+            };
+            $stringValue = static function ($value) use ($ffi) {
+                return $ffi->uiNewTableValueString((string)$value);
+            };
+        }
+
+        $this->columnCount = max(1, $this->columnCount, $this->store->getColumnCount());
+        $this->cellFactories = [];
+        $this->valueTypes = [];
+        for ($column = 0; $column < $this->columnCount; $column++) {
+            $isCheckbox = ($this->columnTypes[$column] ?? null) === 'checkbox';
+            $this->cellFactories[$column] = $isCheckbox ? $intValue : $stringValue;
+            $this->valueTypes[$column] = $isCheckbox ? TableValueType::Int->value : TableValueType::String->value;
+        }
+        $this->defaultCellFactory = $stringValue;
+    }
+
+    /**
+     * CellValue 回调：返回单元格的 uiTableValue
+     */
+    public function cellValue(int $row, int $column): CData {
+        $factory = $this->cellFactories[$column] ?? $this->defaultCellFactory;
+        try {
+            return $factory($this->source->getCell($row, $column));
+        } catch (\Throwable $e) {
+            // 在回调函数中不能抛出异常，返回默认值
+            return $factory(null);
+        }
+    }
+
+    /**
+     * SetCellValue 回调：用户编辑单元格
+     */
+    private function setCellValue(int $row, int $column, CData $value): void {
+        try {
+            $isCheckbox = ($this->columnTypes[$column] ?? null) === 'checkbox';
+            $oldValue = $this->source->getCell($row, $column);
+            $newValue = $isCheckbox ? Table::valueInt($value) : Table::valueStr($value);
+            $this->source->setCell($row, $column, $newValue);
+
+            // 如果是复选框列且值发生了变化，触发事件
+            if ($isCheckbox && (int)$oldValue !== $newValue) {
+                $this->emit('table.checkbox_changed', [
+                    'row' => $row,
+                    'column' => $column,
+                    'old_value' => $oldValue,
+                    'new_value' => $newValue
+                ]);
+            }
+        } catch (\Throwable $e) {
+            // 在回调函数中不能抛出异常，记录后静默处理
+            $this->logger->error("SetCellValue error", ['error' => $e->getMessage()]);
+        }
+    }
+
     public function addTextColumn(string $name, int $textColumn): self {
         $this->columns[] = ['name' => $name, 'type' => 'text', 'index' => $textColumn];
-        $this->columnTypes[$textColumn] = 'text';
-        $this->initialColumnCount = max($this->initialColumnCount, $textColumn + 1);
-        return $this;
+        return $this->declareColumn($textColumn, 'text', ColumnarTableData::TYPE_STRING);
     }
 
     public function addButtonColumn(string $name, int $buttonColumn, int $clickableColumn): self {
         $this->columns[] = ['name' => $name, 'type' => 'button', 'index' => $buttonColumn, 'clickable' => $clickableColumn];
-        $this->columnTypes[$buttonColumn] = 'button';
-        $this->initialColumnCount = max($this->initialColumnCount, $buttonColumn + 1);
-        return $this;
+        return $this->declareColumn($buttonColumn, 'button', ColumnarTableData::TYPE_STRING);
     }
 
     public function addCheckboxColumn(string $name, int $checkboxColumn, int $editableColumn): self {
         $this->columns[] = ['name' => $name, 'type' => 'checkbox', 'index' => $checkboxColumn, 'editable' => $editableColumn];
-        $this->columnTypes[$checkboxColumn] = 'checkbox';
-        $this->initialColumnCount = max($this->initialColumnCount, $checkboxColumn + 1);
+        return $this->declareColumn($checkboxColumn, 'checkbox', ColumnarTableData::TYPE_INT);
+    }
+
+    private function declareColumn(int $column, string $type, string $storeType): self {
+        $this->columnTypes[$column] = $type;
+        $this->store->setColumnType($column, $storeType);
+        $this->columnCount = max($this->columnCount, $column + 1);
+        $this->resolveColumnTypes();
+        return $this;
+    }
+
+    /**
+     * 设置数据源
+     *
+     * 大数据量时应在表格句柄创建（getHandle）之前调用：此时不需要逐行发送插入通知。
+     */
+    public function setDataSource(LibuiTableDataSource $source): self {
+        $this->source = $source;
+        $this->refreshRows();
+        $this->emit('table.data_updated', ['row_count' => $source->getRowCount()]);
+        return $this;
+    }
+
+    public function getDataSource(): LibuiTableDataSource {
+        return $this->source;
+    }
+
+    /**
+     * 数据源内容变化后通知表格
+     *
+     * 行数变化会发送插入/删除通知；[$from, $to) 区间内的行发送变化通知。
+     */
+    public function refreshRows(int $from = 0, ?int $to = null): self {
+        $newCount = $this->source->getRowCount();
+        if ($this->model === null) {
+            $this->rowCount = $newCount;
+            return $this;
+        }
+        $to = min($to ?? $newCount, $newCount, $this->rowCount);
+        $this->syncRowCount($newCount, $from < $to ? range($from, $to - 1) : []);
         return $this;
     }
 
     public function setData(array $data): self {
-        // 保存旧数据
-        $oldData = $this->data;
-        $oldRowCount = count($oldData);
-        $newRowCount = count($data);
-        
-        // 更新数据
-        $this->data = $data;
-        $this->initialRowCount = $newRowCount; // 直接使用实际行数
-        
-        // 如果模型已经创建，尝试更新而不是重新创建
-        if ($this->model !== null) {
-            // 通知模型行数变化
-            if ($newRowCount > $oldRowCount) {
-                // 添加新行
-                for ($i = $oldRowCount; $i < $newRowCount; $i++) {
-                    Table::modelRowInserted($this->model, $i);
-                }
-            } else if ($newRowCount < $oldRowCount) {
-                // 删除多余行
-                for ($i = $oldRowCount - 1; $i >= $newRowCount; $i--) {
-                    Table::modelRowDeleted($this->model, $i);
-                }
-            } else {
-                // 更新现有行
-                for ($i = 0; $i < $newRowCount; $i++) {
-                    Table::modelRowChanged($this->model, $i);
-                }
-            }
-        } else {
-            // 如果没有模型，重新创建handle
-            $this->handle = $this->createHandle();
+        // 切换回内置列式存储
+        $usingStore = $this->source === $this->store;
+        $this->source = $this->store;
+
+        // 只通知真正变化的行
+        $oldRowCount = $this->rowCount;
+        $changed = $this->store->setRows($data);
+        if (!$usingStore) {
+            $common = min($oldRowCount, count($data));
+            $changed = $common > 0 ? range(0, $common - 1) : [];
         }
+        $this->syncRowCount(count($data), $changed);
         
         // 发送数据更新事件
-        $this->emit('table.data_updated', ['row_count' => $newRowCount]);
+        $this->emit('table.data_updated', ['row_count' => count($data)]);
         
         return $this;
     }
 
     public function addRow(array $row): self {
-        $this->data[] = $row;
-        $this->initialRowCount = count($this->data);
-        
-        // 如果模型已经创建，通知添加新行
+        return $this->insertRow($this->assertStore()->getRowCount(), $row);
+    }
+
+    public function insertRow(int $index, array $row): self {
+        $this->assertStore()->insertRow($index, $row);
+        $index = max(0, min($index, $this->rowCount));
+        $this->rowCount++;
+
+        // 如果模型已经创建，只通知插入的这一行
         if ($this->model !== null) {
-            $rowIndex = count($this->data) - 1;
-            Table::modelRowInserted($this->model, $rowIndex);
-        } else {
-            // 否则重新创建handle
-            $this->handle = $this->createHandle();
+            Table::modelRowInserted($this->model, $index);
+        }
+
+        return $this;
+    }
+
+    public function updateRow(int $index, array $row): self {
+        // 内容没有变化时不通知
+        if ($this->assertStore()->updateRow($index, $row) && $this->model !== null) {
+            Table::modelRowChanged($this->model, $index);
         }
-        
         return $this;
     }
 
     public function removeRow(int $index): self {
-        if (isset($this->data[$index])) {
-            array_splice($this->data, $index, 1);
-            $this->initialRowCount = count($this->data);
-            
+        if ($index >= 0 && $index < $this->assertStore()->getRowCount()) {
+            $this->store->removeRow($index);
+            $this->rowCount--;
+
             // 如果模型已经创建，通知删除行
             if ($this->model !== null) {
                 Table::modelRowDeleted($this->model, $index);
-            } else {
-                // 否则重新创建handle
-                $this->handle = $this->createHandle();
             }
         }
         return $this;
     }
 
+    /**
+     * 按行数差异发送删除/插入通知，并通知公共部分中发生变化的行
+     */
+    private function syncRowCount(int $newCount, array $changedRows): void {
+        if ($this->model === null) {
+            $this->rowCount = $newCount;
+            return;
+        }
+
+        // 先从末尾删除多余行
+        while ($this->rowCount > $newCount) {
+            $this->rowCount--;
+            Table::modelRowDeleted($this->model, $this->rowCount);
+        }
+
+        foreach ($changedRows as $row) {
+            if ($row < $this->rowCount) {
+                Table::modelRowChanged($this->model, $row);
+            }
+        }
+
+        // 再追加新行
+        while ($this->rowCount < $newCount) {
+            $this->rowCount++;
+            Table::modelRowInserted($this->model, $this->rowCount - 1);
+        }
+    }
+
+    /**
+     * 逐行操作只支持内置存储
+     */
+    private function assertStore(): ColumnarTableData {
+        if ($this->source !== $this->store) {
+            throw new RuntimeException("Row operations are only supported on the built-in table store, call setData() first");
+        }
+        return $this->store;
+    }
+
     public function getSelection(): int {
         // 获取当前选择的行号
         // 注意：selectionRow函数可能不存在，需要检查libui文档
@@ -287,7 +361,7 @@ class LibuiTable extends LibuiComponent
     }
 
     public function onSelectionChanged(callable $callback): self {
-        Table::onSelectionChanged($this->getHandle(), function($table) use ($callback) {
+        Table::onSelectionChanged($this->getHandle(), $this->profiler->wrap('table.onSelectionChanged', function($table) use ($callback) {
             // 延迟获取选择信息，确保在事件触发时获取最新状态
             $selection = -1;
             $selections = [];
@@ -299,7 +373,7 @@ class LibuiTable extends LibuiComponent
             }
             $callback($selection, $selections, $this);
             $this->emit('table.selection_changed', ['selected_row' => $selection, 'selected_rows' => $selections]);
-        });
+        }));
         return $this;
     }
 }
@@ -0,0 +1,26 @@
+<?php
+
+namespace Kingbes\Libui\SDK;
+
+/**
+ * 表格数据源接口
+ *
+ * LibuiTable 在绘制时按需调用 getCell()，数据源无需一次性把全部行放进PHP数组。
+ */
+interface LibuiTableDataSource
+{
+    /**
+     * 行数
+     */
+    public function getRowCount(): int;
+
+    /**
+     * 读取单元格值，不存在时返回 null
+     */
+    public function getCell(int $row, int $column): mixed;
+
+    /**
+     * 写入单元格值（用户编辑复选框、文本时调用）
+     */
+    public function setCell(int $row, int $column, mixed $value): void;
+}
@@ -0,0 +1,91 @@
+<?php
+
+use Kingbes\Libui\SDK\EventManager;
+use Kingbes\Libui\SDK\LibuiComponent;
+use Kingbes\Libui\SDK\LibuiProfiler;
+
+/*
+ * 事件分发：直接 emit、多优先级监听、合并订阅和性能分析器包装后的监听。
+ * 合并订阅的 uiQueueMain 回调用数组队列代替，不需要 libui。
+ */
+
+function benchmarkSource(): LibuiComponent
+{
+    return new class extends LibuiComponent {
+        protected function createHandle(): \FFI\CData {
+            throw new \LogicException('headless source');
+        }
+    };
+}
+
+test('event dispatch throughput', function () {
+    $iterations = benchmarkIterations(200000);
+    $source = benchmarkSource();
+
+    $single = new EventManager();
+    $sum = 0;
+    $single->on('bench', function ($source, $data) use (&$sum) {
+        $sum += $data;
+    });
+    $rate = benchmark('emit, 1 listener', $iterations, fn($i) => $single->emit('bench', $source, $i));
+
+    $many = new EventManager();
+    $order = [];
+    for ($i = 0; $i < 10; $i++) {
+        $priority = $i % 3;
+        $many->on('bench', function () use (&$order, $priority) {
+            $order[] = $priority;
+        }, $priority);
+    }
+    benchmark('emit, 10 listeners in 3 priorities', $iterations, function ($i) use ($many, $source, &$order) {
+        $order = [];
+        $many->emit('bench', $source, $i);
+    });
+
+    $profiler = (new LibuiProfiler())->enable();
+    $profiled = new EventManager();
+    $profiled->on('bench', $profiler->wrap('bench listener', function ($source, $data) use (&$sum) {
+        $sum += $data;
+    }, 'listener'));
+    benchmark('emit, 1 profiled listener', $iterations, fn($i) => $profiled->emit('bench', $source, $i));
+    $profiler->disable();
+
+    // 高优先级先执行，同优先级按注册顺序
+    expect($rate)->toBeGreaterThan(0)
+        ->and($order)->toBe([2, 2, 2, 1, 1, 1, 0, 0, 0, 0])
+        ->and($profiler->getStats()[0]['count'])->toBe($iterations + 1);
+});
+
+test('coalesced listener runs once per main loop turn', function () {
+    $bursts = benchmarkIterations(2000);
+    $source = benchmarkSource();
+    $queue = [];
+    $manager = new EventManager();
+    $manager->setScheduler(
+        function (callable $callback) use (&$queue) {
+            $queue[] = $callback;
+        },
+        function (int $milliseconds, callable $callback) use (&$queue) {
+            $queue[] = $callback;
+        }
+    );
+
+    $delivered = [];
+    $manager->onCoalesced('slider', function ($source, $value) use (&$delivered) {
+        $delivered[] = $value;
+    });
+
+    // 每"帧"触发 100 次，帧末执行主循环队列
+    benchmark('coalesced emit x100 + drain', $bursts, function ($frame) use ($manager, $source, &$queue) {
+        for ($i = 0; $i < 100; $i++) {
+            $manager->emit('slider', $source, $frame * 100 + $i);
+        }
+        while ($queue) {
+            array_shift($queue)();
+        }
+    });
+
+    // 预热一帧，每帧只处理最后一次
+    expect($delivered)->toHaveCount($bursts + 1)
+        ->and(end($delivered))->toBe(($bursts - 1) * 100 + 99);
+});
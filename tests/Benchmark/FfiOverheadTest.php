@@ -0,0 +1,48 @@
+<?php
+
+use Kingbes\Libui\Base;
+use Kingbes\Libui\SDK\LibuiProfiler;
+
+/*
+ * FFI 调用开销：纯 PHP 闭包、经由 Base::ffi() 的 libui 调用、缓存 FFI 实例后的调用，以及性能分析器包装后的开销。
+ * 只调用不依赖 uiInit 的函数，不需要图形环境。
+ */
+
+test('ffi call overhead', function () {
+    $iterations = benchmarkIterations(100000);
+    $ffi = Base::ffi();
+
+    $php = benchmark('php closure', $iterations, fn($i) => $i);
+    $lookup = benchmark('Base::ffi() new + free table value', $iterations, function ($i) {
+        Base::ffi()->uiFreeTableValue(Base::ffi()->uiNewTableValueInt($i));
+    });
+    $cached = benchmark('cached FFI new + free table value', $iterations, function ($i) use ($ffi) {
+        $ffi->uiFreeTableValue($ffi->uiNewTableValueInt($i));
+    });
+
+    expect($php)->toBeGreaterThan(0)
+        ->and($lookup)->toBeGreaterThan(0)
+        ->and($cached)->toBeGreaterThan(0);
+})->skip(fn() => !libuiAvailable(), 'libui 动态库不可用');
+
+test('profiler wrapper overhead and ffi call counting', function () {
+    $iterations = benchmarkIterations(100000);
+    $profiler = (new LibuiProfiler())->enable(1000.0, 1024);
+
+    $callback = function ($i) {
+        Base::ffi()->uiFreeTableValue(Base::ffi()->uiNewTableValueInt($i));
+    };
+    $plain = benchmark('unwrapped callback', $iterations, $callback);
+    $wrapped = benchmark('profiler-wrapped callback', $iterations, $profiler->wrap('bench', $callback));
+    // 关闭后 Base::ffi() 不再计数，不影响之后的测试
+    $profiler->disable();
+
+    $stats = $profiler->getStats();
+    fwrite(STDERR, sprintf("    %-44s %12.2fx\n", 'wrapper slowdown', $plain / $wrapped));
+
+    // 预热也算一次调用；每次调用经过两次 Base::ffi()
+    expect($stats)->toHaveCount(1)
+        ->and($stats[0]['count'])->toBe($iterations + 1)
+        ->and($stats[0]['ffi_calls'])->toEqual(2)
+        ->and($profiler->getSamples())->toHaveCount(min(1024, $iterations + 1));
+})->skip(fn() => !libuiAvailable(), 'libui 动态库不可用');
@@ -0,0 +1,65 @@
+<?php
+
+use Kingbes\Libui\Base;
+use Kingbes\Libui\SDK\LibuiProfiler;
+use Kingbes\Libui\SDK\LibuiTable;
+use Kingbes\Libui\Table;
+
+/*
+ * 表格单元格吞吐量：按 CellValue 回调的方式逐个取出单元格的 uiTableValue。
+ * 不创建表格句柄（getHandle），所以不需要图形环境。
+ */
+
+function benchmarkTable(int $rows): LibuiTable
+{
+    $data = [];
+    for ($i = 0; $i < $rows; $i++) {
+        $data[] = [$i % 2, (string)(1000 + $i), "user$i", "/usr/bin/process-$i --option=$i"];
+    }
+    return (new LibuiTable())
+        ->addCheckboxColumn("选择", 0, -1)
+        ->addTextColumn("PID", 1)
+        ->addTextColumn("User", 2)
+        ->addTextColumn("Command", 3)
+        ->setData($data);
+}
+
+test('table cell throughput', function () {
+    $rows = benchmarkIterations(10000);
+    $table = benchmarkTable($rows);
+    $ffi = Base::ffi();
+
+    $cells = $rows * 4;
+    $rate = benchmark("cellValue ($rows rows x 4 columns)", $cells, function ($i) use ($table, $ffi) {
+        $ffi->uiFreeTableValue($table->cellValue(intdiv($i, 4), $i % 4));
+    });
+
+    // 抽查取值
+    $value = $table->cellValue(3, 2);
+    expect(Table::valueStr($value))->toBe('user3');
+    $ffi->uiFreeTableValue($value);
+
+    expect($rate)->toBeGreaterThan(0);
+})->skip(fn() => !libuiAvailable(), 'libui 动态库不可用');
+
+test('table cell throughput with profiler', function () {
+    $rows = benchmarkIterations(10000);
+    // 先开启性能分析，表格的取值闭包才会计入 FFI 调用
+    $profiler = (new LibuiProfiler())->enable();
+    $table = benchmarkTable($rows);
+    $ffi = Base::ffi();
+
+    // 与 LibuiTable 模型处理程序中的包装方式相同：只计入直方图
+    $cellValue = $profiler->wrap('table.CellValue', fn($row, $column) => $table->cellValue($row, $column), 'table', false);
+    $cells = $rows * 4;
+    benchmark("profiled cellValue ($rows rows x 4 columns)", $cells, function ($i) use ($cellValue, $ffi) {
+        $ffi->uiFreeTableValue($cellValue(intdiv($i, 4), $i % 4));
+    });
+    $profiler->disable();
+
+    $stats = $profiler->getStats();
+    expect($stats[0]['count'])->toBe($cells + 1)
+        ->and(array_sum($stats[0]['buckets']))->toBe($cells + 1)
+        ->and($stats[0]['ffi_calls'])->toEqual(1)
+        ->and($profiler->getSamples())->toBeEmpty();
+})->skip(fn() => !libuiAvailable(), 'libui 动态库不可用');
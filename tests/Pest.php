@@ -43,3 +43,44 @@ function something(): void
 {
     // ..
 }
+
+/**
+ * 基准测试：预热一次后执行 $callback $iterations 次，输出每秒次数并返回
+ */
+function benchmark(string $label, int $iterations, callable $callback): float
+{
+    $callback(0);
+    $start = hrtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $callback($i);
+    }
+    $seconds = max((hrtime(true) - $start) / 1e9, 1e-9);
+    $rate = $iterations / $seconds;
+    fwrite(STDERR, sprintf("    %-44s %12.0f/s %10.3f µs\n", $label, $rate, $seconds * 1e6 / $iterations));
+    return $rate;
+}
+
+/**
+ * 基准测试的迭代次数，可以用环境变量 BENCH_SCALE 按比例调整
+ */
+function benchmarkIterations(int $iterations): int
+{
+    return max(1, (int)($iterations * (float)(getenv('BENCH_SCALE') ?: 1)));
+}
+
+/**
+ * libui 动态库能否加载（不需要图形环境，只是不调用 uiInit）
+ */
+function libuiAvailable(): bool
+{
+    static $available = null;
+    if ($available === null) {
+        try {
+            Kingbes\Libui\Base::ffi();
+            $available = true;
+        } catch (Throwable $e) {
+            $available = false;
+        }
+    }
+    return $available;
+}